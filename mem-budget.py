@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+"""Бюджет RAM/flash по модулям из карты линковки (obj/output.map).
+
+Использование:
+  mem-budget.py output.map [--objs obj/*.o] [--nm arm-none-eabi-gcc-nm]
+                [--ram-max N] [--flash-max N] [--top N]
+
+Секции раскладываются по объектным файлам. После LTO код и данные лежат
+в *.ltrans.o — такие секции приписываются модулю по имени символа
+(таблица символов объектов через gcc-nm). Статические символы в таблице
+LTO не видны, они выводятся отдельной строкой со своим именем.
+
+Код возврата 1, если .data+.bss больше --ram-max или образ во flash
+больше --flash-max.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+from collections import defaultdict
+
+KINDS = {
+    ".text": "text",
+    ".rodata": "text",
+    ".isr_vector": "text",
+    ".ARM": "text",
+    ".ARM.extab": "text",
+    ".init_array": "text",
+    ".fini_array": "text",
+    ".preinit_array": "text",
+    ".data": "data",
+    ".bss": "bss",
+}
+
+OUT_RE = re.compile(r"^(\.[\w.]+)(?:\s|$)")
+IN_RE = re.compile(r"^ (\S+)(?:\s+(0x[0-9a-f]+)\s+(0x[0-9a-f]+)\s+(.+))?$")
+CONT_RE = re.compile(r"^\s+(0x[0-9a-f]+)\s+(0x[0-9a-f]+)\s+(.+)$")
+SUFFIX_RE = re.compile(r"\.(lto_priv|constprop|isra|part|cold)\.\d+.*$")
+
+
+def module_of(path):
+    m = re.match(r"(.*\.a)\((.+)\)$", path)
+    if m:
+        return os.path.basename(m.group(1))
+    path = os.path.normpath(path)
+    for prefix in ("obj" + os.sep,):
+        if path.startswith(prefix):
+            path = path[len(prefix):]
+    return os.path.splitext(path)[0]
+
+
+def symbol_of(section):
+    for prefix in (".text.", ".rodata.", ".data.", ".bss."):
+        if section.startswith(prefix):
+            return SUFFIX_RE.sub("", section[len(prefix):])
+    return None
+
+
+def load_symbols(nm, objs):
+    owners = {}
+    for obj in objs:
+        try:
+            out = subprocess.run([nm, "--defined-only", obj],
+                                 capture_output=True, text=True).stdout
+        except OSError:
+            return owners
+        for line in out.splitlines():
+            parts = line.split()
+            if len(parts) == 3:
+                owners.setdefault(parts[2], module_of(obj))
+    return owners
+
+
+def parse_map(path):
+    """Входные секции: (выходная секция, входная секция, размер, файл)."""
+    items = []
+    out_section = None
+    pending = None
+    in_layout = False
+    with open(path) as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if line.startswith("Linker script and memory map"):
+                in_layout = True
+                continue
+            if not in_layout:
+                continue
+
+            m = OUT_RE.match(line)
+            if m:
+                out_section = m.group(1)
+                pending = None
+                continue
+
+            if pending:
+                m = CONT_RE.match(line)
+                section, pending = pending, None
+                if m:
+                    items.append((out_section, section, int(m.group(2), 16),
+                                  m.group(3).strip()))
+                    continue
+
+            m = IN_RE.match(line)
+            if not m or m.group(1).startswith(("0x", "*")):
+                continue
+            if m.group(2) is None:
+                pending = m.group(1)  # длинное имя, адрес на следующей строке
+                continue
+            items.append((out_section, m.group(1), int(m.group(3), 16),
+                          m.group(4).strip()))
+    return items
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("map")
+    ap.add_argument("--objs", nargs="*", default=[])
+    ap.add_argument("--nm", default="arm-none-eabi-gcc-nm")
+    ap.add_argument("--ram-max", type=int, default=0)
+    ap.add_argument("--flash-max", type=int, default=0)
+    ap.add_argument("--top", type=int, default=0)
+    args = ap.parse_args()
+
+    owners = load_symbols(args.nm, args.objs) if args.objs else {}
+    budget = defaultdict(lambda: {"text": 0, "data": 0, "bss": 0})
+    totals = {"text": 0, "data": 0, "bss": 0}
+
+    for out_section, section, size, path in parse_map(args.map):
+        kind = KINDS.get(out_section)
+        if not kind or not size:
+            continue
+        name = module_of(path)
+        if ".ltrans" in path:
+            sym = symbol_of(section)
+            name = owners.get(sym, sym and "[%s]" % sym or section)
+        budget[name][kind] += size
+        totals[kind] += size
+
+    rows = sorted(budget.items(),
+                  key=lambda kv: (kv[1]["data"] + kv[1]["bss"], kv[1]["text"]),
+                  reverse=True)
+    if args.top:
+        rows = rows[:args.top]
+
+    print("%-32s %7s %7s %7s" % ("module", ".text", ".data", ".bss"))
+    for name, b in rows:
+        print("%-32s %7u %7u %7u" % (name, b["text"], b["data"], b["bss"]))
+
+    ram = totals["data"] + totals["bss"]
+    flash = totals["text"] + totals["data"]
+    print("%-32s %7u %7u %7u" % ("total", totals["text"], totals["data"],
+                                 totals["bss"]))
+    print("RAM %u%s, FLASH %u%s" % (
+        ram, args.ram_max and " / %u" % args.ram_max or "",
+        flash, args.flash_max and " / %u" % args.flash_max or ""))
+
+    failed = False
+    if args.ram_max and ram > args.ram_max:
+        print("ERROR: RAM budget exceeded by %u bytes" % (ram - args.ram_max))
+        failed = True
+    if args.flash_max and flash > args.flash_max:
+        print("ERROR: FLASH budget exceeded by %u bytes" %
+              (flash - args.flash_max))
+        failed = True
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,10 +1,21 @@
 #include "about.h"
+#include "../driver/systick.h"
+#include "../helper/memory.h"
+#include "../helper/scheduler.h"
 #include "../ui/graphics.h"
 
 void ABOUT_Render() {
-  PrintMediumEx(LCD_XCENTER, LCD_YCENTER - 8, POS_C, C_FILL, "hawk5");
-  PrintSmallEx(LCD_XCENTER, LCD_YCENTER, POS_C, C_FILL, "by FAGCI");
-  PrintSmallEx(LCD_XCENTER, LCD_YCENTER + 8, POS_C, C_FILL, TIME_STAMP);
+  PrintMediumEx(LCD_XCENTER, LCD_YCENTER - 16, POS_C, C_FILL, "hawk5");
+  PrintSmallEx(LCD_XCENTER, LCD_YCENTER - 8, POS_C, C_FILL, "by FAGCI");
+  PrintSmallEx(LCD_XCENTER, LCD_YCENTER, POS_C, C_FILL, TIME_STAMP);
+  const SchedTask *top = SCHED_GetTop();
+  PrintSmallEx(LCD_XCENTER, LCD_YCENTER + 8, POS_C, C_FILL,
+               "Idle %u%% Top %s %u%%", SYSTICK_GetIdlePercent(),
+               top ? top->name : "-", top ? top->load : 0);
+  const MemStats mem = MEM_GetStats();
+  PrintSmallEx(LCD_XCENTER, LCD_YCENTER + 16, POS_C, C_FILL,
+               "RAM %u Stk %u Free %u", mem.statics, mem.stackPeak,
+               mem.freeMin);
   PrintSmallEx(LCD_XCENTER, LCD_YCENTER + 24, POS_C, C_FILL,
                "t.me/uvk5_spectrum_talk");
 }
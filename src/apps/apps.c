@@ -1,6 +1,7 @@
 #include "apps.h"
 #include "../driver/st7565.h"
 #include "../driver/uart.h"
+#include "../helper/arena.h"
 #include "../helper/menu.h"
 #include "../ui/graphics.h"
 #include "../ui/statusline.h"
@@ -26,6 +27,8 @@ AppType_t gCurrentApp = APP_NONE;
 static AppType_t loadedVfoApp = APP_NONE;
 
 static AppType_t appsStack[APPS_STACK_SIZE] = {APP_NONE};
+// Начало памяти приложения в ARENA на каждом уровне стека
+static uint16_t arenaMarks[APPS_STACK_SIZE];
 static int8_t stackIndex = -1;
 
 static bool pushApp(AppType_t app) {
@@ -35,8 +38,14 @@ static bool pushApp(AppType_t app) {
     for (uint8_t i = 1; i < APPS_STACK_SIZE; ++i) {
       appsStack[i - 1] = appsStack[i];
     }
+    // Нижний уровень наследует отметку вытесненного приложения,
+    // иначе его память в пуле не вернется
+    for (uint8_t i = 2; i < APPS_STACK_SIZE; ++i) {
+      arenaMarks[i - 1] = arenaMarks[i];
+    }
     appsStack[stackIndex] = app;
   }
+  arenaMarks[stackIndex] = ARENA_Mark();
   return true;
 }
 
@@ -105,14 +114,25 @@ bool APPS_key(KEY_Code_t Key, KEY_State_t state) {
 }
 
 void APPS_init(AppType_t app) {
+  // init выделяет память заново: при возврате из вложенного приложения
+  // пул откатывается к началу уровня, адреса выделений повторяются
+  ARENA_Release(arenaMarks[stackIndex]);
 
   STATUSLINE_SetText("%s", apps[app].name);
   gRedrawScreen = true;
 
   LogC(LOG_C_YELLOW, "[APP] Init %s", apps[gCurrentApp].name);
+  ARENA_Failed();
   if (apps[app].init) {
     apps[app].init();
   }
+  Log("[APP] Arena %u/%u, peak %u", ARENA_Mark(), ARENA_SIZE, ARENA_Peak());
+
+  // Пул занят цепочкой под приложением: возвращаемся к предыдущему. На
+  // нижнем уровне пул откатывается до нуля, там выделение всегда проходит
+  if (ARENA_Failed() && APPS_exit()) {
+    STATUSLINE_SetText("No memory");
+  }
 }
 
 void APPS_update(void) {
@@ -134,6 +154,12 @@ void APPS_deinit(void) {
   if (apps[gCurrentApp].deinit) {
     apps[gCurrentApp].deinit();
   }
+  SCHED_RemoveOwner(gCurrentApp);
+}
+
+bool APPS_AddTask(const char *name, SchedFn fn, uint16_t period,
+                  SchedPriority prio) {
+  return SCHED_Add(gCurrentApp, name, fn, period, prio);
 }
 
 RadioState radioState;
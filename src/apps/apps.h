@@ -2,6 +2,7 @@
 #define APPS_H
 
 #include "../driver/keyboard.h"
+#include "../helper/scheduler.h"
 #include "../radio.h"
 
 #define RUN_APPS_COUNT 8
@@ -51,5 +52,8 @@ void APPS_render(void);
 void APPS_run(AppType_t app);
 void APPS_runManual(AppType_t app);
 bool APPS_exit(void);
+// Периодическая задача текущего приложения, снимается при его deinit
+bool APPS_AddTask(const char *name, SchedFn fn, uint16_t period,
+                  SchedPriority prio);
 
 #endif /* end of include guard: APPS_H */
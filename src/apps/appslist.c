@@ -1,35 +1,35 @@
 #include "appslist.h"
 #include "../helper/channels.h"
 #include "../helper/menu.h"
+#include "../ui/graphics.h"
 #include "apps.h"
 #include "chlist.h"
 #include <sys/types.h>
 
-static MenuItem appsItems[RUN_APPS_COUNT];
-
-static Menu appsMenu = {"Apps", appsItems, RUN_APPS_COUNT};
+// Пункты берутся прямо из таблицы приложений: меню без items не занимает
+// RAM и открывается поверх любого приложения
+static void renderItem(uint16_t index, uint8_t i) {
+  PrintMediumEx(3, MENU_Y + i * MENU_ITEM_H + 8, POS_L, C_INVERT, "%s",
+                apps[appsAvailableToRun[index]].name);
+}
 
-static bool run(const MenuItem *item, KEY_Code_t key, Key_State_t state) {
+static bool action(const uint16_t index, KEY_Code_t key, Key_State_t state) {
   if (state == KEY_RELEASED && key == KEY_MENU) {
+    AppType_t app = appsAvailableToRun[index];
     APPS_exit();
-    if (item->setting == APP_CH_LIST) {
+    if (app == APP_CH_LIST) {
       gChListFilter = TYPE_FILTER_CH;
     }
-    APPS_runManual(item->setting);
+    APPS_runManual(app);
     return true;
   }
   return false;
 }
 
-void APPSLIST_init(void) {
-  for (uint8_t i = 0; i < RUN_APPS_COUNT; ++i) {
-    AppType_t app = appsAvailableToRun[i];
-    appsItems[i].name = apps[app].name;
-    appsItems[i].action = run;
-    appsItems[i].setting = app;
-  }
-  MENU_Init(&appsMenu);
-}
+static Menu appsMenu = {"Apps", .num_items = RUN_APPS_COUNT,
+                        .render_item = renderItem, .action = action};
+
+void APPSLIST_init(void) { MENU_Init(&appsMenu); }
 
 bool APPSLIST_key(KEY_Code_t key, Key_State_t state) {
   if (MENU_HandleInput(key, state)) {
@@ -1,5 +1,6 @@
 #include "chlist.h"
 #include "../driver/uart.h"
+#include "../helper/arena.h"
 #include "../helper/bands.h"
 #include "../helper/menu.h"
 #include "../radio.h"
@@ -49,8 +50,8 @@ bool gChSaveMode = false;
 CHTypeFilter gChListFilter = TYPE_FILTER_CH;
 
 static uint8_t viewMode = MODE_INFO;
-static CH ch;
-static char tempName[10] = {0};
+static char *tempName; // имя для TEXTINPUT, в ARENA
+static void initMenu();
 
 static const Symbol typeIcons[] = {
     [TYPE_CH] = SYM_CH,         [TYPE_BAND] = SYM_BAND,
@@ -64,7 +65,7 @@ static inline uint16_t getChannelNumber(uint16_t menuIndex) {
     Log("ERROR: menuIndex %u >= gScanlistSize %u", menuIndex, gScanlistSize);
     return 0; // или другое безопасное значение
   }
-  return gScanlist[menuIndex];
+  return CHANNELS_ScanlistAt(menuIndex);
 }
 
 static void renderItem(uint16_t index, uint8_t i) {
@@ -73,35 +74,27 @@ static void renderItem(uint16_t index, uint8_t i) {
     return;
   }
 
-  uint16_t chNum = getChannelNumber(index);
-
-  CHANNELS_Load(chNum, &ch);
+  const CHRow *row = CHANNELS_GetRow(getChannelNumber(index));
 
   uint8_t y = MENU_Y + i * MENU_ITEM_H;
 
-  if (ch.meta.type) {
-    PrintSymbolsEx(2, y + 8, POS_L, C_INVERT, "%c", typeIcons[ch.meta.type]);
-    PrintMediumEx(13, y + 8, POS_L, C_INVERT, "%s", ch.name);
-  } else {
-    PrintMediumEx(13, y + 8, POS_L, C_INVERT, "CH-%u", chNum);
+  if (row->meta.type) {
+    PrintSymbolsEx(2, y + 8, POS_L, C_INVERT, "%c", typeIcons[row->meta.type]);
   }
+  PrintMediumEx(13, y + 8, POS_L, C_INVERT, "%s", row->name);
 
   switch (viewMode) {
   case MODE_INFO:
-    if (CHANNELS_IsFreqable(ch.meta.type)) {
-      PrintSmallEx(LCD_WIDTH - 5, y + 8, POS_R, C_INVERT, "%u.%03u %u.%03u",
-                   ch.rxF / MHZ, ch.rxF / 100 % 1000, ch.txF / MHZ,
-                   ch.txF / 100 % 1000);
-    }
+    PrintSmallEx(LCD_WIDTH - 5, y + 8, POS_R, C_INVERT, "%s", row->freq);
     break;
   case MODE_SCANLIST:
-    if (CHANNELS_IsScanlistable(ch.meta.type)) {
-      UI_Scanlists(LCD_WIDTH - 32, y + 3, ch.scanlists);
+    if (CHANNELS_IsScanlistable(row->meta.type)) {
+      UI_Scanlists(LCD_WIDTH - 32, y + 3, row->scanlists);
     }
     break;
   case MODE_TX:
     PrintSmallEx(LCD_WIDTH - 5, y + 7, POS_R, C_INVERT, "%s",
-                 ch.allowTx ? "ON" : "OFF");
+                 row->allowTx ? "ON" : "OFF");
     break;
   }
 }
@@ -126,12 +119,13 @@ static void saveNamed() {
 
 static bool action(const uint16_t index, KEY_Code_t key, Key_State_t state) {
   uint16_t chNum = getChannelNumber(index);
+  CH ch;
   if (viewMode == MODE_SCANLIST || viewMode == MODE_SCANLIST_SELECT) {
     if ((state == KEY_LONG_PRESSED || state == KEY_RELEASED) &&
         (key > KEY_0 && key < KEY_9)) {
       if (viewMode == MODE_SCANLIST_SELECT) {
         CHANNELS_SelectScanlistByKey(key, state == KEY_LONG_PRESSED);
-        CHLIST_init();
+        initMenu();
       } else {
         CHANNELS_Load(chNum, &ch);
         ch.scanlists = CHANNELS_ScanlistByKey(ch.scanlists, key,
@@ -203,7 +197,8 @@ static bool action(const uint16_t index, KEY_Code_t key, Key_State_t state) {
 static Menu chListMenu = {
     .render_item = renderItem, .itemHeight = MENU_ITEM_H, .action = action};
 
-void CHLIST_init() {
+// Перечитать список без нового выделения в ARENA
+static void initMenu() {
   if (gChSaveMode) {
     gChListFilter = 1 << gChEd.meta.type | (1 << TYPE_EMPTY);
   }
@@ -211,7 +206,7 @@ void CHLIST_init() {
   Log("Scanlist loaded: size=%u", gScanlistSize);
 
   /* for (uint16_t i = 0; i < gScanlistSize; i++) {
-    Log("gScanlist[%u] = %u", i, gScanlist[i]);
+    Log("gScanlist[%u] = %u", i, CHANNELS_ScanlistAt(i));
   } */
 
   chListMenu.num_items = gScanlistSize;
@@ -228,6 +223,15 @@ void CHLIST_init() {
   } */
 }
 
+// Только из APPS_init: пул уже откачен к началу уровня приложения
+void CHLIST_init() {
+  tempName = ARENA_Alloc(10);
+  if (!tempName) {
+    return;
+  }
+  initMenu();
+}
+
 void CHLIST_deinit() { gChSaveMode = false; }
 
 bool CHLIST_key(KEY_Code_t key, Key_State_t state) {
@@ -237,7 +241,7 @@ bool CHLIST_key(KEY_Code_t key, Key_State_t state) {
       gSettings.currentScanlist = 0;
       SETTINGS_Save();
       CHANNELS_LoadScanlist(TYPE_FILTER_CH, gSettings.currentScanlist);
-      CHLIST_init();
+      initMenu();
       break;
     default:
       break;
@@ -2,6 +2,7 @@
 
 #include "../driver/systick.h"
 #include "../driver/uart.h"
+#include "../helper/arena.h"
 #include "../helper/channels.h"
 #include "../helper/lootlist.h"
 #include "../helper/scan.h"
@@ -10,7 +11,7 @@
 #include "../ui/graphics.h"
 #include "apps.h"
 
-CH activeCh;
+static CH *activeCh; // канал с открытым шумодавом, в ARENA
 
 static uint32_t lastSqCheck;
 static uint32_t timeout = 0;
@@ -22,6 +23,7 @@ static void nextWithTimeout() {
     lastListenState = vfo->is_open;
     if (vfo->is_open) {
       CHANNELS_LoadCurrentScanlistCH();
+      CHANNELS_Load(CHANNELS_GetCurrentScanlistCH(), activeCh);
       isWaiting = true;
     }
     SetTimeout(&timeout, vfo->is_open
@@ -38,12 +40,20 @@ static void nextWithTimeout() {
   }
 }
 
-void CHSCAN_init(void) {
+static void loadScanlist(void) {
   CHANNELS_LoadScanlist(TYPE_FILTER_CH, gSettings.currentScanlist);
   SCAN_SetMode(SCAN_MODE_CHANNEL);
   // SCAN_Init(false);
 }
 
+void CHSCAN_init(void) {
+  activeCh = ARENA_Alloc(sizeof(CH));
+  if (!activeCh) {
+    return;
+  }
+  loadScanlist();
+}
+
 void CHSCAN_deinit(void) {}
 
 void CHSCAN_update(void) {}
@@ -53,7 +63,7 @@ bool CHSCAN_key(KEY_Code_t key, Key_State_t state) {
   bool simpleKeypress = state == KEY_RELEASED;
   if ((longHeld || simpleKeypress) && (key > KEY_0 && key < KEY_9)) {
     CHANNELS_SelectScanlistByKey(key, longHeld && !simpleKeypress);
-    CHSCAN_init();
+    loadScanlist();
     isWaiting = false;
     return true;
   }
@@ -84,7 +94,7 @@ bool CHSCAN_key(KEY_Code_t key, Key_State_t state) {
 void CHSCAN_render(void) {
   if (gScanlistSize) {
     if (vfo->is_open) {
-      PrintMediumBoldEx(LCD_XCENTER, 18, POS_C, C_FILL, "%s", activeCh.name);
+      PrintMediumBoldEx(LCD_XCENTER, 18, POS_C, C_FILL, "%.10s", activeCh->name);
     } else {
       PrintMediumEx(LCD_XCENTER, 18, POS_C, C_FILL,
                     isWaiting ? "Waiting..." : "Scanning...");
@@ -1,6 +1,7 @@
 #include "reset.h"
 #include "../driver/eeprom.h"
 #include "../driver/st7565.h"
+#include "../helper/arena.h"
 #include "../helper/channels.h"
 #include "../radio.h"
 #include "../external/CMSIS/Device/PY32F071/Include/py32f071xB.h"
@@ -16,16 +17,18 @@ typedef enum {
 
 static char *RESET_TYPE_NAMES[] = {"0xFF", "FULL"};
 
-static struct {
+typedef struct {
   uint32_t totalBytes;
   uint32_t doneBytes;
   uint16_t pageSize;
   uint16_t maxChannels;
   uint16_t currentItem;
   ResetType type;
-} resetState;
+} ResetState;
 
-static VFO defaultVfos[4] = {
+static ResetState *job; // в ARENA
+
+static const VFO defaultVfos[4] = {
     {.rxF = 14550000,
      .meta.type = TYPE_VFO,
      .gainIndex = AUTO_GAIN_INDEX,
@@ -45,42 +48,42 @@ static VFO defaultVfos[4] = {
 };
 
 static void startReset(ResetType type) {
-  resetState.type = type;
-  resetState.doneBytes = 0;
-  resetState.currentItem = 0;
-  resetState.totalBytes = (type == RESET_0xFF)
+  job->type = type;
+  job->doneBytes = 0;
+  job->currentItem = 0;
+  job->totalBytes = (type == RESET_0xFF)
                               ? SETTINGS_GetEEPROMSize()
-                              : resetState.maxChannels * CH_SIZE;
+                              : job->maxChannels * CH_SIZE;
 }
 
 static bool processReset(void) {
-  if (resetState.type == RESET_0xFF) {
-    uint16_t page = resetState.doneBytes / resetState.pageSize;
+  if (job->type == RESET_0xFF) {
+    uint16_t page = job->doneBytes / job->pageSize;
     EEPROM_ClearPage(page);
-    resetState.doneBytes += resetState.pageSize;
-    return resetState.doneBytes >= resetState.totalBytes;
+    job->doneBytes += job->pageSize;
+    return job->doneBytes >= job->totalBytes;
   }
 
   // RESET_FULL
-  if (resetState.currentItem == 0) {
+  if (job->currentItem == 0) {
     SETTINGS_Save();
-    resetState.doneBytes += SETTINGS_SIZE;
-    resetState.currentItem++;
+    job->doneBytes += SETTINGS_SIZE;
+    job->currentItem++;
     return false;
   }
 
-  uint16_t chIndex = resetState.currentItem - 1;
+  uint16_t chIndex = job->currentItem - 1;
   uint8_t numVFOs = ARRAY_SIZE(defaultVfos);
 
-  if (chIndex < resetState.maxChannels - numVFOs) {
+  if (chIndex < job->maxChannels - numVFOs) {
     CHANNELS_Delete(chIndex);
-    resetState.doneBytes += CH_SIZE;
-    resetState.currentItem++;
+    job->doneBytes += CH_SIZE;
+    job->currentItem++;
     return false;
   }
 
-  if (chIndex < resetState.maxChannels) {
-    uint8_t vfoIndex = chIndex - (resetState.maxChannels - numVFOs);
+  if (chIndex < job->maxChannels) {
+    uint8_t vfoIndex = chIndex - (job->maxChannels - numVFOs);
     VFO vfo = defaultVfos[vfoIndex];
     sprintf(vfo.name, "VFO-%c", 'A' + vfoIndex);
     vfo.meta.type = TYPE_VFO;
@@ -96,8 +99,8 @@ static bool processReset(void) {
     vfo.squelch.value = 4;
     vfo.step = STEP_25_0kHz;
     CHANNELS_Save(chIndex, &vfo);
-    resetState.doneBytes += CH_SIZE;
-    resetState.currentItem++;
+    job->doneBytes += CH_SIZE;
+    job->currentItem++;
     return false;
   }
 
@@ -105,23 +108,27 @@ static bool processReset(void) {
 }
 
 void RESET_Init(void) {
-  resetState.type = RESET_UNKNOWN;
+  job = ARENA_Alloc(sizeof(ResetState));
+  if (!job) {
+    return;
+  }
+  job->type = RESET_UNKNOWN;
   gSettings.keylock = false;
   gSettings.eepromType = EEPROM_M24M02;
-  resetState.pageSize = SETTINGS_GetPageSize();
-  resetState.maxChannels = CHANNELS_GetCountMax();
+  job->pageSize = SETTINGS_GetPageSize();
+  job->maxChannels = CHANNELS_GetCountMax();
   STATUSLINE_SetText("%s", EEPROM_TYPE_NAMES[gSettings.eepromType]);
 }
 
 void RESET_Update(void) {
-  if (resetState.type == RESET_UNKNOWN || !processReset()) {
+  if (job->type == RESET_UNKNOWN || !processReset()) {
     return;
   }
   NVIC_SystemReset();
 }
 
 void RESET_Render(void) {
-  if (resetState.type == RESET_UNKNOWN) {
+  if (job->type == RESET_UNKNOWN) {
     for (uint8_t i = 0; i < ARRAY_SIZE(RESET_TYPE_NAMES); i++) {
       PrintMedium(2, 18 + i * 8, "%u: %s", i, RESET_TYPE_NAMES[i]);
     }
@@ -129,7 +136,7 @@ void RESET_Render(void) {
   }
 
   uint8_t progress =
-      ConvertDomain(resetState.doneBytes, 0, resetState.totalBytes, 0, 100);
+      ConvertDomain(job->doneBytes, 0, job->totalBytes, 0, 100);
   const uint8_t TOP = 28;
   DrawRect(13, TOP, 102, 9, C_FILL);
   FillRect(14, TOP + 1, progress, 7, C_FILL);
@@ -137,7 +144,7 @@ void RESET_Render(void) {
 }
 
 bool RESET_key(KEY_Code_t k, Key_State_t state) {
-  if (state == KEY_RELEASED && resetState.type == RESET_UNKNOWN) {
+  if (state == KEY_RELEASED && job->type == RESET_UNKNOWN) {
     uint8_t t = k - KEY_0;
     if (t < ARRAY_SIZE(RESET_TYPE_NAMES)) {
       startReset(t);
@@ -5,6 +5,7 @@
 #include "../helper/bands.h"
 #include "../helper/lootlist.h"
 #include "../helper/measurements.h"
+#include "../helper/recorder.h"
 #include "../helper/regs-menu.h"
 #include "../helper/scan.h"
 #include "../radio.h"
@@ -20,6 +21,7 @@ static VMinMax minMaxRssi;
 static uint32_t cursorRangeTimeout = 0;
 static bool isAnalyserMode = false;
 static bool pttWasLongPressed = false;
+static KEY_Code_t longPressedKey = KEY_NONE;
 
 static void setRange(uint32_t fs, uint32_t fe) {
   BANDS_RangeClear();
@@ -87,6 +89,14 @@ static bool handleLongPress(KEY_Code_t key) {
     APPS_run(APP_CH_LIST);
     return true;
 
+  case KEY_STAR:
+    if (REC_IsActive()) {
+      REC_Stop();
+    } else {
+      REC_Start();
+    }
+    return true;
+
   case KEY_PTT:
     if (gSettings.keylock) {
       pttWasLongPressed = true;
@@ -192,6 +202,12 @@ static bool handleRelease(KEY_Code_t key) {
     APPS_run(APP_LOOT_LIST);
     return true;
 
+  case KEY_6:
+    if (CUR_NextPeak(true)) {
+      cursorRangeTimeout = Now() + 2000;
+    }
+    return true;
+
   case KEY_2:
     BANDS_RangePush(CUR_GetRange(BANDS_RangePeek(), step));
     SCAN_setBand(*BANDS_RangePeek());
@@ -217,12 +233,25 @@ bool SCANER_key(KEY_Code_t key, Key_State_t state) {
     return true;
   }
 
-  if (state == KEY_PRESSED && key == KEY_PTT) {
-    pttWasLongPressed = false;
+  if (state == KEY_PRESSED) {
+    longPressedKey = KEY_NONE;
+    if (key == KEY_PTT) {
+      pttWasLongPressed = false;
+    }
   }
 
   if (state == KEY_LONG_PRESSED) {
-    return handleLongPress(key);
+    if (handleLongPress(key)) {
+      longPressedKey = key;
+      return true;
+    }
+    return false;
+  }
+
+  // Отпускание после long press уже обработано
+  if (state == KEY_RELEASED && key == longPressedKey) {
+    longPressedKey = KEY_NONE;
+    return true;
   }
 
   if (state == KEY_LONG_PRESSED_CONT) {
@@ -266,6 +295,12 @@ static void renderTopInfo(void) {
   }
 
   PrintSmallEx(0, 24, POS_L, C_FILL, "CPS %u", SCAN_GetCps());
+
+  const Peak *peak = CUR_GetPeak();
+  if (peak && Now() < cursorRangeTimeout) {
+    PrintSmallEx(LCD_XCENTER, 24, POS_C, C_FILL, "BW %u.%02uk",
+                 peak->bw / 100, peak->bw % 100);
+  }
 }
 
 static void renderBottomFreq(uint32_t step) {
@@ -315,4 +350,4 @@ void SCANER_render(void) {
   REGSMENU_Draw();
 }
 
-void SCANER_deinit(void) {}
+void SCANER_deinit(void) { REC_Stop(); }
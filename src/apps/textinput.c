@@ -1,5 +1,6 @@
 #include "textinput.h"
 #include "../driver/st7565.h"
+#include "../helper/arena.h"
 #include "../ui/graphics.h"
 #include "apps.h"
 #include <string.h>
@@ -48,7 +49,7 @@ static const char *symbols[9] = {
 
 static const char **currentSet = lettersCapital;
 static const char *currentRow;
-static char inputField[16] = {0};
+static char *inputField; // в ARENA
 static uint8_t inputIndex = 0;
 static bool coursorBlink = true;
 
@@ -72,6 +73,10 @@ static void backspace(void) {
 }
 
 void TEXTINPUT_init(void) {
+  inputField = ARENA_Alloc(16);
+  if (!inputField) {
+    return;
+  }
   strcpy(inputField, gTextinputText);
   inputIndex = strlen(inputField);
 }
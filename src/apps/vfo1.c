@@ -8,6 +8,7 @@
 #include "../helper/channels.h"
 #include "../helper/measurements.h"
 #include "../helper/numnav.h"
+#include "../helper/rds.h"
 #include "../helper/regs-menu.h"
 #include "../helper/scan.h"
 #include "../radio.h"
@@ -44,8 +45,15 @@ static void tuneTo(uint32_t f, uint32_t _) {
   updateBand();
 }
 
+static void rdsTask(void) {
+  if (ctx->radio_type == RADIO_SI4732) {
+    RDS_Update();
+  }
+}
+
 void VFO1_init(void) {
   gLastActiveLoot = NULL;
+  APPS_AddTask("rds", rdsTask, 20, SCHED_PRIO_HOUSEKEEPING);
   CHANNELS_LoadScanlist(TYPE_FILTER_CH, gSettings.currentScanlist);
   if (vfo->mode == MODE_CHANNEL) {
     setChannel(vfo->channel_index);
@@ -327,7 +335,22 @@ static void renderExtraInfo(uint8_t BASE) {
   if (isTxFDifferent) {
     PrintSmallEx(LCD_XCENTER, BASE + 6, POS_C, C_FILL, "TX: %s",
                  RADIO_GetParamValueString(ctx, PARAM_TX_FREQUENCY_FACT));
+  } else if (ctx->radio_type == RADIO_SI4732 && gRDS.ps[0]) {
+    if (gRDS.ctValid) {
+      PrintSmallEx(LCD_XCENTER, BASE + 6, POS_C, C_FILL, "%s %02u:%02u",
+                   gRDS.ps, gRDS.hour, gRDS.minute);
+    } else {
+      PrintSmallEx(LCD_XCENTER, BASE + 6, POS_C, C_FILL, "%s", gRDS.ps);
+    }
+  }
+}
+
+static void renderRDSText(void) {
+  // Нижняя строка занята информацией о последней активности
+  if (ctx->radio_type != RADIO_SI4732 || !gRDS.rt[0] || gLastActiveLoot) {
+    return;
   }
+  PrintSmallEx(0, LCD_HEIGHT - 1, POS_L, C_FILL, "%s", gRDS.rt);
 }
 
 static void renderLootInfo(void) {
@@ -416,6 +439,7 @@ void VFO1_render(void) {
   renderCodes(BASE);
   renderExtraInfo(BASE);
   renderLootInfo();
+  renderRDSText();
 
   if (gMonitorMode) {
     renderMonitorMode(BASE);
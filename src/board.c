@@ -8,8 +8,12 @@
 #include "external/PY32F071_HAL_Driver/Inc/py32f071_ll_adc.h"
 #include "external/PY32F071_HAL_Driver/Inc/py32f071_ll_bus.h"
 #include "external/PY32F071_HAL_Driver/Inc/py32f071_ll_dac.h"
+#include "external/PY32F071_HAL_Driver/Inc/py32f071_ll_dma.h"
 #include "external/PY32F071_HAL_Driver/Inc/py32f071_ll_gpio.h"
 #include "external/PY32F071_HAL_Driver/Inc/py32f071_ll_rcc.h"
+#include "external/PY32F071_HAL_Driver/Inc/py32f071_ll_system.h"
+#include "external/PY32F071_HAL_Driver/Inc/py32f071_ll_tim.h"
+#include "misc.h"
 #include <stdint.h>
 
 void BOARD_GPIO_Init(void) {
@@ -79,6 +83,43 @@ void BOARD_GPIO_Init(void) {
   LL_GPIO_Init(GPIOF, &InitStruct);
 }
 
+// Последовательность: ранг 1 — канал 8 (батарея), ранг 2 — канал 9 (APRS)
+#define ADC_CHANNELS 2
+#define ADC_DMA_CHANNEL LL_DMA_CHANNEL_1
+
+// Кольцевой буфер DMA: последние BOARD_ADC_OVERSAMPLE пар отсчетов
+static volatile uint16_t adcBuf[BOARD_ADC_OVERSAMPLE * ADC_CHANNELS];
+
+static void adcTimerInit(void) {
+  LL_APB1_GRP1_EnableClock(LL_APB1_GRP1_PERIPH_TIM3);
+  LL_TIM_SetPrescaler(TIM3, 0);
+  LL_TIM_SetAutoReload(TIM3, 48000000 / BOARD_ADC_RATE_HZ - 1);
+  LL_TIM_SetTriggerOutput(TIM3, LL_TIM_TRGO_UPDATE);
+  LL_TIM_EnableCounter(TIM3);
+}
+
+static void adcDmaInit(void) {
+  LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_DMA1);
+  LL_APB1_GRP2_EnableClock(LL_APB1_GRP2_PERIPH_SYSCFG);
+  LL_SYSCFG_SetDMARemap(DMA1, ADC_DMA_CHANNEL, LL_SYSCFG_DMA_MAP_ADC1);
+
+  LL_DMA_ConfigTransfer(DMA1, ADC_DMA_CHANNEL,                //
+                        LL_DMA_DIRECTION_PERIPH_TO_MEMORY     //
+                            | LL_DMA_MODE_CIRCULAR            //
+                            | LL_DMA_PERIPH_NOINCREMENT       //
+                            | LL_DMA_MEMORY_INCREMENT         //
+                            | LL_DMA_PDATAALIGN_HALFWORD      //
+                            | LL_DMA_MDATAALIGN_HALFWORD      //
+                            | LL_DMA_PRIORITY_LOW             //
+  );
+  LL_DMA_SetPeriphAddress(
+      DMA1, ADC_DMA_CHANNEL,
+      LL_ADC_DMA_GetRegAddr(ADC1, LL_ADC_DMA_REG_REGULAR_DATA));
+  LL_DMA_SetMemoryAddress(DMA1, ADC_DMA_CHANNEL, (uint32_t)adcBuf);
+  LL_DMA_SetDataLength(DMA1, ADC_DMA_CHANNEL, ARRAY_SIZE(adcBuf));
+  LL_DMA_EnableChannel(DMA1, ADC_DMA_CHANNEL);
+}
+
 void BOARD_ADC_Init(void) {
   LL_IOP_GRP1_EnableClock(LL_IOP_GRP1_PERIPH_GPIOB);
   LL_GPIO_SetPinMode(GPIOB, LL_GPIO_PIN_0 | LL_GPIO_PIN_1, LL_GPIO_MODE_ANALOG);
@@ -89,50 +130,52 @@ void BOARD_ADC_Init(void) {
   LL_ADC_SetCommonPathInternalCh(ADC1_COMMON, LL_ADC_PATH_INTERNAL_NONE);
   LL_ADC_SetResolution(ADC1, LL_ADC_RESOLUTION_12B);
   LL_ADC_SetDataAlignment(ADC1, LL_ADC_DATA_ALIGN_RIGHT);
-  LL_ADC_SetSequencersScanMode(ADC1, LL_ADC_SEQ_SCAN_DISABLE);
-  LL_ADC_REG_SetTriggerSource(ADC1, LL_ADC_REG_TRIG_SOFTWARE);
+  LL_ADC_SetSequencersScanMode(ADC1, LL_ADC_SEQ_SCAN_ENABLE);
+  // Каждое обновление TIM3 запускает всю последовательность
+  LL_ADC_REG_SetTriggerSource(ADC1, LL_ADC_REG_TRIG_EXT_TIM3_TRGO);
   LL_ADC_REG_SetContinuousMode(ADC1, LL_ADC_REG_CONV_SINGLE);
-  LL_ADC_REG_SetDMATransfer(ADC1, LL_ADC_REG_DMA_TRANSFER_NONE);
-  LL_ADC_REG_SetSequencerLength(ADC1, LL_ADC_REG_SEQ_SCAN_DISABLE);
-  LL_ADC_REG_SetSequencerDiscont(ADC1, LL_ADC_REG_SEQ_DISCONT_DISABLE);
+  LL_ADC_REG_SetDMATransfer(ADC1, LL_ADC_REG_DMA_TRANSFER_UNLIMITED);
+  LL_ADC_REG_SetSequencerLength(ADC1, LL_ADC_REG_SEQ_SCAN_ENABLE_2RANKS);
   LL_ADC_REG_SetSequencerDiscont(ADC1, LL_ADC_REG_SEQ_DISCONT_DISABLE);
   LL_ADC_REG_SetSequencerRanks(ADC1, LL_ADC_REG_RANK_1, LL_ADC_CHANNEL_8);
+  LL_ADC_REG_SetSequencerRanks(ADC1, LL_ADC_REG_RANK_2, LL_ADC_CHANNEL_9);
   LL_ADC_SetChannelSamplingTime(ADC1, LL_ADC_CHANNEL_8,
                                 LL_ADC_SAMPLINGTIME_41CYCLES_5);
-  /* LL_ADC_SetChannelSamplingTime(ADC1, LL_ADC_CHANNEL_9,
-                                LL_ADC_SAMPLINGTIME_41CYCLES_5); */
+  LL_ADC_SetChannelSamplingTime(ADC1, LL_ADC_CHANNEL_9,
+                                LL_ADC_SAMPLINGTIME_41CYCLES_5);
 
   LL_ADC_StartCalibration(ADC1);
   while (LL_ADC_IsCalibrationOnGoing(ADC1))
     ;
 
+  adcDmaInit();
   LL_ADC_Enable(ADC1);
+  LL_ADC_REG_StartConversionExtTrig(ADC1, LL_ADC_REG_TRIG_EXT_RISING);
+  adcTimerInit();
 }
 
-void BOARD_ADC_GetBatteryInfo(uint16_t *pVoltage, uint16_t *pCurrent) {
-  LL_ADC_REG_StartConversionSWStart(ADC1);
-  while (!LL_ADC_IsActiveFlag_EOS(ADC1))
-    ;
-  LL_ADC_ClearFlag_JEOS(ADC1);
+// Сумма BOARD_ADC_OVERSAMPLE отсчетов канала, приведенная к 16 битам.
+// DMA пишет буфер параллельно — для усреднения это не важно
+static uint16_t adcOversampled(uint8_t rank) {
+  uint32_t sum = 0;
+  for (uint16_t i = rank; i < ARRAY_SIZE(adcBuf); i += ADC_CHANNELS) {
+    sum += adcBuf[i];
+  }
+  return sum * BOARD_ADC_SCALE / BOARD_ADC_OVERSAMPLE;
+}
 
-  *pVoltage = LL_ADC_REG_ReadConversionData12(ADC1);
+void BOARD_ADC_GetBatteryInfo(uint16_t *pVoltage, uint16_t *pCurrent) {
+  *pVoltage = adcOversampled(0);
   *pCurrent = 0;
 }
 
-/* uint16_t BOARD_ADC_GetAPRS() {
-  uint16_t v;
-  // Переключение на канал 9 (PB1) и чтение current
-  LL_ADC_REG_SetSequencerRanks(ADC1, LL_ADC_REG_RANK_1, LL_ADC_CHANNEL_9);
-  LL_ADC_REG_StartConversionSWStart(ADC1);
-  while (!LL_ADC_IsActiveFlag_EOS(ADC1))
-    ;
-  LL_ADC_ClearFlag_EOS(ADC1);
-  v = LL_ADC_REG_ReadConversionData12(ADC1);
-
-  // Возврат к каналу 8
-  LL_ADC_REG_SetSequencerRanks(ADC1, LL_ADC_REG_RANK_1, LL_ADC_CHANNEL_8);
-  return v;
-} */
+// Последний отсчет канала 9 (12 бит) — поток для звуковых задач
+uint16_t BOARD_ADC_GetAPRS() {
+  // Индекс следующей записи DMA; канал 9 — нечетные ячейки
+  const uint16_t pos =
+      ARRAY_SIZE(adcBuf) - LL_DMA_GetDataLength(DMA1, ADC_DMA_CHANNEL);
+  return adcBuf[((pos & ~1u) + ARRAY_SIZE(adcBuf) - 1) % ARRAY_SIZE(adcBuf)];
+}
 
 void BOARD_DAC_Init(void) {
   // Настроить PA4 как аналоговый пин
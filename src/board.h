@@ -4,6 +4,14 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+// АЦП опрашивается фоном: TIM3 запускает последовательность каналов 8 и 9,
+// DMA пишет отсчеты в кольцевой буфер
+#define BOARD_ADC_RATE_HZ 8000
+// Отсчетов на канал в буфере: 64 = +3 бита к 12-битному АЦП
+#define BOARD_ADC_OVERSAMPLE 64
+// Масштаб BOARD_ADC_GetBatteryInfo относительно 12-битного отсчета
+#define BOARD_ADC_SCALE 16
+
 void BOARD_FLASH_Init(void);
 void BOARD_GPIO_Init(void);
 void BOARD_ADC_Init(void);
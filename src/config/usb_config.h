@@ -60,6 +60,9 @@
 
 // #define CONFIG_USBDEV_MSC_THREAD
 
+/* Read next sector by DMA while the current one goes out on the bus */
+#define CONFIG_USBDEV_MSC_DOUBLE_BUFFER
+
 #ifdef CONFIG_USBDEV_MSC_THREAD
 #ifndef CONFIG_USBDEV_MSC_STACKSIZE
 #define CONFIG_USBDEV_MSC_STACKSIZE 2048
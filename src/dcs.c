@@ -60,43 +60,90 @@ uint32_t DCS_GetGolayCodeWord(DCS_CodeType_t CodeType, uint8_t Option) {
   return Code;
 }
 
-uint8_t DCS_GetCdcssCode(uint32_t Code) {
-  unsigned int i;
-  for (i = 0; i < 23; i++) {
-    uint32_t Shift;
-
-    if (((Code >> 9) & 0x7U) == 4) {
-      unsigned int j;
-      for (j = 0; j < ARRAY_SIZE(DCS_Options); j++)
-        if (DCS_Options[j] == (Code & 0x1FF))
-          if (DCS_GetGolayCodeWord(2, j) == Code)
-            return j;
+// Классы вращений кодовых слов DCS: (минимум из 23 циклических сдвигов
+// слова Голея << 8) | индекс в DCS_Options, по возрастанию. Получено из
+// DCS_Options и DCS_CalculateGolay. Инверсные коды попадают в классы прямых
+// (D023I = D047N и т.д.), поэтому отдельной таблицы для них нет.
+static const uint32_t DCS_RotationClasses[104] = {
+    0x013EC700, 0x015D6F01, 0x016CBB02, 0x019A3F03, 0x01ABEB04, 0x01E17D05,
+    0x01F9975A, 0x023B6D06, 0x0271FB07, 0x029F9508, 0x02B6AB09, 0x02CDE90A,
+    0x02E4D74D, 0x02FC3D1F, 0x0309DF12, 0x035BA30B, 0x036A7765, 0x03729D51,
+    0x039CF30C, 0x03AD270D, 0x03B5CD0E, 0x03CE8F0F, 0x03D66559, 0x03E7B167,
+    0x044B7B25, 0x047AAF3E, 0x04C6BD10, 0x04DE5711, 0x04F76940, 0x052BB513,
+    0x05335F5C, 0x0550F714, 0x0579C941, 0x058F4D3D, 0x0597A715, 0x05A67316,
+    0x05BE9942, 0x05C5DB17, 0x05DD3121, 0x05ECE561, 0x062E1F20, 0x0636F518,
+    0x064DB74E, 0x06555D19, 0x067C6333, 0x068AE760, 0x06A3D91A, 0x06BB3357,
+    0x06D89B1B, 0x06E94F1C, 0x06F1A54F, 0x071CAD54, 0x072D791D, 0x0735935D,
+    0x074ED164, 0x07563B1E, 0x07916B2F, 0x07EA2927, 0x08AB5722, 0x08B3BD2E,
+    0x08F92B3F, 0x0925F746, 0x093D1D23, 0x09465F50, 0x095EB524, 0x09778B2D,
+    0x0999E55B, 0x09CB9943, 0x09D37362, 0x09E2A72A, 0x09FA4D4C, 0x0A38B726,
+    0x0A5B1F28, 0x0A6ACB29, 0x0AAD9B2B, 0x0ACE3358, 0x0AD6D92C, 0x0B233B44,
+    0x0B69AD30, 0x0B9F2931, 0x0BCD5532, 0x0BE46B45, 0x0C797556, 0x0C971B34,
+    0x0CA6CF66, 0x0CDD8D35, 0x0CF4B355, 0x0D4BC739, 0x0D532D36, 0x0D947D37,
+    0x0DA5A938, 0x0E4E6D5F, 0x0E67533A, 0x0E91D73B, 0x0EEA953C, 0x0F36495E,
+    0x126EA547, 0x12764F63, 0x12A9F548, 0x12CA5D49, 0x12D2B74A, 0x1327554B,
+    0x1534EB52, 0x15669753,
+};
+
+static uint32_t DCS_MinRotation(uint32_t Code) {
+  uint32_t Min = Code;
+  for (uint8_t i = 1; i < 23; i++) {
+    Code = (Code >> 1) | ((Code & 1U) << 22);
+    if (Code < Min) {
+      Min = Code;
     }
+  }
+  return Min;
+}
+
+uint8_t DCS_GetCdcssCode(uint32_t Code) {
+  const uint32_t Key = DCS_MinRotation(Code & 0x7FFFFFU);
+  uint8_t lo = 0;
+  uint8_t hi = ARRAY_SIZE(DCS_RotationClasses);
 
-    Shift = Code >> 1;
-    if (Code & 1U)
-      Shift |= 0x400000U;
-    Code = Shift;
+  while (lo < hi) {
+    uint8_t mid = (lo + hi) / 2;
+    uint32_t MidKey = DCS_RotationClasses[mid] >> 8;
+    if (MidKey == Key) {
+      return DCS_RotationClasses[mid] & 0xFF;
+    }
+    if (MidKey < Key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
   }
 
   return 0xFF;
 }
 
+// Ближайший тон не дальше 5 Гц; CTCSS_Options отсортирована по возрастанию
 uint8_t DCS_GetCtcssCode(uint16_t Code) {
-  unsigned int i;
-  uint8_t Result = 0xFF;
-  int Smallest = ARRAY_SIZE(CTCSS_Options);
-
-  for (i = 0; i < ARRAY_SIZE(CTCSS_Options); i++) {
-    int Delta = Code - CTCSS_Options[i];
-    if (Delta < 0)
-      Delta = -(Code - CTCSS_Options[i]);
-    if (Smallest > Delta) {
-      Smallest = Delta;
-      Result = i;
+  const int MaxDelta = 50;
+  uint8_t lo = 0;
+  uint8_t hi = ARRAY_SIZE(CTCSS_Options);
+
+  // Первый тон >= Code
+  while (lo < hi) {
+    uint8_t mid = (lo + hi) / 2;
+    if (CTCSS_Options[mid] < Code) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
     }
   }
 
+  // При равном удалении — нижний тон
+  uint8_t Result = 0xFF;
+  int Smallest = MaxDelta;
+  if (lo > 0 && Code - CTCSS_Options[lo - 1] < Smallest) {
+    Smallest = Code - CTCSS_Options[lo - 1];
+    Result = lo - 1;
+  }
+  if (lo < ARRAY_SIZE(CTCSS_Options) && CTCSS_Options[lo] - Code < Smallest) {
+    Result = lo;
+  }
+
   return Result;
 }
 
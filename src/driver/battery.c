@@ -8,8 +8,9 @@ uint16_t gBatteryCurrent = 0;
 uint8_t gBatteryPercent = 0;
 bool gChargingWithTypeC = true;
 
+// Отсчеты АЦП в масштабе BOARD_ADC_SCALE
 static uint16_t batAdcV = 0;
-static uint16_t batAvgV = 0;
+static uint32_t batAvgV = 0;
 
 const char *BATTERY_TYPE_NAMES[3] = {"1600mAh", "2200mAh", "3500mAh"};
 const char *BATTERY_STYLE_NAMES[3] = {"Icon", "%", "V"};
@@ -105,16 +106,18 @@ void BATTERY_UpdateBatteryInfo() {
   if (batAvgV == 0 || charg != gChargingWithTypeC) {
     batAvgV = batAdcV;
   } else {
-    batAvgV = batAvgV - (batAvgV - batAdcV) / 7;
+    // Передискретизация уже сгладила шум, фильтр гасит просадки под нагрузкой
+    batAvgV = batAvgV - ((int32_t)(batAvgV - batAdcV) >> 3);
   }
 
-  gBatteryVoltage = (batAvgV * 760) / gSettings.batteryCalibration;
+  gBatteryVoltage =
+      (batAvgV * 760) / (gSettings.batteryCalibration * BOARD_ADC_SCALE);
   gChargingWithTypeC = charg;
   gBatteryPercent = BATTERY_VoltsToPercent(gBatteryVoltage);
 }
 
 uint32_t BATTERY_GetPreciseVoltage(uint16_t cal) {
-  return batAvgV * 76000 / cal;
+  return batAvgV * (76000 / BOARD_ADC_SCALE) / cal;
 }
 
 uint16_t BATTERY_GetCal(uint32_t v) {
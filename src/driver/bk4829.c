@@ -665,6 +665,14 @@ uint8_t BK4819_GetCTCType(void) {
   return (BK4819_ReadRegister(BK4819_REG_0C) >> 10) & 3;
 }
 
+uint16_t BK4819_ReadInterrupts(void) {
+  if (!(BK4819_ReadRegister(BK4819_REG_0C) & 1)) {
+    return 0;
+  }
+  BK4819_WriteRegister(BK4819_REG_02, 0);
+  return BK4819_ReadRegister(BK4819_REG_02);
+}
+
 // ============================================================================
 // DTMF
 // ============================================================================
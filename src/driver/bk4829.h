@@ -194,6 +194,10 @@ uint8_t BK4819_GetDTMF_5TONE_Code(void);
 uint8_t BK4819_GetCDCSSCodeType(void);
 uint8_t BK4819_GetCTCType(void);
 
+// Флаги прерываний REG_02 (маска в REG_3F), 0 — запроса нет. Чтение
+// сбрасывает запрос
+uint16_t BK4819_ReadInterrupts(void);
+
 void BK4819_PlaySequence(const uint16_t *M);
 void BK4819_PlayRogerTiny(void);
 
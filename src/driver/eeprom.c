@@ -11,11 +11,21 @@ void EEPROM_ReadBuffer(uint32_t address, void *pBuffer, uint16_t size) {
   PY25Q16_ReadBuffer(address, pBuffer, size);
 }
 
+// Записи лежат вплотную: страница переписывается целиком, не только до
+// конца записываемых данных
 void EEPROM_WriteBuffer(uint32_t address, uint8_t *pBuffer, uint16_t size) {
   gEepromWrite = true;
-  PY25Q16_WriteBuffer(address, pBuffer, size, true);
+  PY25Q16_WriteBuffer(address, pBuffer, size, false);
 }
 
+// Массовая запись (импорт): стирание раз на 4 КБ в EEPROM_CommitBatch
+void EEPROM_WriteBatch(uint32_t address, const void *pBuffer, uint16_t size) {
+  gEepromWrite = true;
+  PY25Q16_BatchWrite(address, pBuffer, size);
+}
+
+void EEPROM_CommitBatch(void) { PY25Q16_BatchEnd(); }
+
 void EEPROM_ClearPage(uint16_t page) {
   uint8_t buf[256];
   memset(buf, 0xff, sizeof(buf));
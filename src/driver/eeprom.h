@@ -9,6 +9,8 @@ extern bool gEepromWrite;
 
 void EEPROM_ReadBuffer(uint32_t Address, void *pBuffer, uint16_t Size);
 void EEPROM_WriteBuffer(uint32_t Address, uint8_t *pBuffer, uint16_t Size);
+void EEPROM_WriteBatch(uint32_t address, const void *pBuffer, uint16_t size);
+void EEPROM_CommitBatch(void);
 void EEPROM_ClearPage(uint16_t page);
 bool EEPROM_Detect(uint8_t device_addr);
 uint16_t EEPROM_GetPageSize(void);
@@ -1,11 +1,22 @@
 #include "fat_fs.h"
+#include "../external/CMSIS/Device/PY32F071/Include/py32f071xB.h"
 #include "../external/printf/printf.h"
+#include "../misc.h"
 #include "py25q16.h"
+#include "systick.h"
 #include <string.h>
 
 // Внешние функции для работы с флеш
 
 static bool fs_formatted = false;
+static bool fatLoaded = false;
+
+// Кеш записи MSC: LBA копятся в служебном erase-блоке, целевой блок
+// стирается один раз — при смене блока, по простою или SYNCHRONIZE_CACHE
+#define WB_NONE 0xFFFFFFFF
+static uint32_t wbBlock = WB_NONE;
+static uint8_t wbStaged; // LBA блока, лежащие в служебном секторе
+static uint32_t wbTime;
 
 // Создание Boot Sector
 static void FAT_CreateBootSector(fat_boot_sector_t *bs) {
@@ -49,10 +60,10 @@ static void FAT_CreateBootSector(fat_boot_sector_t *bs) {
 static void FAT_CreateFATTable(uint8_t *buf) {
   memset(buf, 0, FAT_SECTOR_SIZE);
 
-  // First two entries reserved
-  uint16_t *fat = (uint16_t *)buf;
-  fat[0] = 0xFFF0; // Change to match media 0xF0 (was 0xFFF8)
-  fat[1] = 0xFFFF; // End of chain for first cluster
+  // First two FAT12 entries reserved: media 0xF0 + end of chain
+  buf[0] = 0xF0;
+  buf[1] = 0xFF;
+  buf[2] = 0xFF;
 }
 
 // Создание Root Directory с volume label
@@ -76,18 +87,36 @@ static void FAT_CreateRootDir(uint8_t *buf) {
   entry->file_size = 0;
 }
 
+static void journalRecover(void);
+
+// Блок 0 стирается при сбросе журнала: если питание пропало до записи
+// загрузочного сектора, FAT цела и сектор создается заново
+static bool restoreBootSector(void) {
+  uint8_t media[3];
+  PY25Q16_ReadBuffer(FAT_BASE_ADDR + FAT_TABLE_SECTOR * FAT_SECTOR_SIZE, media,
+                     3);
+  if (media[0] != 0xF0 || media[1] != 0xFF || media[2] != 0xFF) {
+    return false;
+  }
+  fat_boot_sector_t bs;
+  FAT_CreateBootSector(&bs);
+  PY25Q16_Program(FAT_BASE_ADDR, &bs, sizeof(fat_boot_sector_t));
+  return true;
+}
+
 void FAT_Init(void) {
   PY25Q16_Init();
   printf("Flash init done\n");
 
   // Сигнатура находится по offset 510-511 (0x1FE-0x1FF)
   uint8_t sig[2];
-  PY25Q16_ReadBuffer(510, sig, 2);
+  PY25Q16_ReadBuffer(FAT_BASE_ADDR + 510, sig, 2);
 
   printf("Boot sig: %02X %02X\n", sig[0], sig[1]);
 
-  if (sig[0] == 0x55 && sig[1] == 0xAA) {
+  if ((sig[0] == 0x55 && sig[1] == 0xAA) || restoreBootSector()) {
     fs_formatted = true;
+    journalRecover();
     printf("FS already formatted\n");
   } else {
     printf("Formatting flash...\n");
@@ -114,63 +143,839 @@ void FAT_Init(void) {
   }
 } */
 
+bool FAT_IsReady(void) { return fs_formatted; }
+
 void FAT_Format(void) {
   uint8_t buf[FAT_SECTOR_SIZE];
 
-  // 1. Erase first 32KB (covers boot + 2 FATs + root)
-  for (uint32_t addr = 0; addr < 32768; addr += 4096) {
-    PY25Q16_SectorErase(addr);
+  // Отложенная запись хоста все равно будет затерта
+  wbBlock = WB_NONE;
+
+  // 1. Erase system area (boot + 2 FATs + root)
+  for (uint32_t addr = 0; addr < FAT_DATA_SECTOR * FAT_SECTOR_SIZE;
+       addr += PY25Q16_ERASE_SIZE) {
+    PY25Q16_SectorErase(FAT_BASE_ADDR + addr);
   }
 
   // 2. Create and write Boot Sector
   fat_boot_sector_t bs;
   FAT_CreateBootSector(&bs);
-  PY25Q16_WriteBuffer(0, &bs, sizeof(fat_boot_sector_t), false);
+  PY25Q16_WriteBuffer(FAT_BASE_ADDR, &bs, sizeof(fat_boot_sector_t), false);
 
   // 3. Create and write FAT tables (now 2, identical)
-  FAT_CreateFATTable(buf);
-
   for (int fat_num = 0; fat_num < FAT_NUM_FATS; fat_num++) {
+    FAT_CreateFATTable(buf);
     uint32_t fat_addr =
+        FAT_BASE_ADDR +
         (FAT_TABLE_SECTOR + fat_num * FAT_SECTORS_PER_FAT) * FAT_SECTOR_SIZE;
     PY25Q16_WriteBuffer(fat_addr, buf, FAT_SECTOR_SIZE, false);
 
     // Remaining FAT sectors = zeros
     memset(buf, 0, FAT_SECTOR_SIZE);
     for (int i = 1; i < FAT_SECTORS_PER_FAT; i++) {
-      uint32_t addr = (FAT_TABLE_SECTOR + fat_num * FAT_SECTORS_PER_FAT + i) *
-                      FAT_SECTOR_SIZE;
+      uint32_t addr =
+          FAT_BASE_ADDR +
+          (FAT_TABLE_SECTOR + fat_num * FAT_SECTORS_PER_FAT + i) *
+              FAT_SECTOR_SIZE;
       PY25Q16_WriteBuffer(addr, buf, FAT_SECTOR_SIZE, false);
     }
   }
 
   // 4. Create and write Root Directory
   FAT_CreateRootDir(buf);
-  uint32_t root_addr = FAT_ROOT_DIR_SECTOR * FAT_SECTOR_SIZE;
+  uint32_t root_addr = FAT_BASE_ADDR + FAT_ROOT_DIR_SECTOR * FAT_SECTOR_SIZE;
   PY25Q16_WriteBuffer(root_addr, buf, FAT_SECTOR_SIZE, false);
 
   // Remaining root sectors = zeros
   memset(buf, 0, FAT_SECTOR_SIZE);
   for (int i = 1; i < FAT_ROOT_DIR_SECTORS; i++) {
-    uint32_t addr = (FAT_ROOT_DIR_SECTOR + i) * FAT_SECTOR_SIZE;
+    uint32_t addr = FAT_BASE_ADDR + (FAT_ROOT_DIR_SECTOR + i) * FAT_SECTOR_SIZE;
     PY25Q16_WriteBuffer(addr, buf, FAT_SECTOR_SIZE, false);
   }
 
   fs_formatted = true;
+  fatLoaded = false;
+}
+
+// =============================
+// Файлы
+// =============================
+
+#define FAT_TABLE_ADDR(n)                                                      \
+  (FAT_BASE_ADDR + (FAT_TABLE_SECTOR + (n) * FAT_SECTORS_PER_FAT) *            \
+                       FAT_SECTOR_SIZE)
+#define FAT_ROOT_ADDR (FAT_BASE_ADDR + FAT_ROOT_DIR_SECTOR * FAT_SECTOR_SIZE)
+#define FAT12_BYTES (((FAT_CLUSTER_COUNT + 2) * 3 + 1) / 2)
+#define FAT12_LAST 0xFF8 // >= — конец цепочки
+
+// Кеш FAT12 в RAM: выделение кластеров меняет только его,
+// на флеш таблица попадает в FAT_Sync
+static uint8_t fatTable[FAT12_BYTES];
+static bool fatDirty;
+static uint16_t freeHint = 2;
+// Меняется, когда хост пишет FAT: открытые прошивкой файлы больше не
+// дописываются, их цепочка могла разойтись с таблицей хоста
+static uint8_t fatGen;
+
+static void syncTable(void);
+
+static uint32_t clusterAddr(uint16_t cluster) {
+  return FAT_BASE_ADDR +
+         (FAT_DATA_SECTOR + (cluster - 2) * FAT_SECTORS_PER_CLUSTER) *
+             FAT_SECTOR_SIZE;
+}
+
+static uint32_t dirEntryAddr(uint16_t index) {
+  return FAT_ROOT_ADDR + index * sizeof(fat_dir_entry_t);
+}
+
+static void loadTable(void) {
+  if (!fatLoaded) {
+    syncTable(); // несохраненные выделения прошивки не выбрасываем
+    PY25Q16_ReadBuffer(FAT_TABLE_ADDR(0), fatTable, FAT12_BYTES);
+    fatLoaded = true;
+    fatDirty = false;
+    freeHint = 2;
+  }
+}
+
+static uint16_t getEntry(uint16_t cluster) {
+  const uint8_t *p = fatTable + cluster + cluster / 2;
+  uint16_t v = p[0] | (p[1] << 8);
+  return (cluster & 1) ? v >> 4 : v & 0xFFF;
+}
+
+static void setEntry(uint16_t cluster, uint16_t value) {
+  uint8_t *p = fatTable + cluster + cluster / 2;
+  if (cluster & 1) {
+    p[0] = (p[0] & 0x0F) | (value << 4);
+    p[1] = value >> 4;
+  } else {
+    p[0] = value;
+    p[1] = (p[1] & 0xF0) | (value >> 8);
+  }
+  fatDirty = true;
+}
+
+static bool isValidCluster(uint16_t cluster) {
+  return cluster >= 2 && cluster < FAT_CLUSTER_COUNT + 2;
+}
+
+static uint16_t allocCluster(uint16_t prev) {
+  for (uint16_t n = 0; n < FAT_CLUSTER_COUNT; ++n) {
+    uint16_t c = freeHint + n;
+    if (c >= FAT_CLUSTER_COUNT + 2) {
+      c -= FAT_CLUSTER_COUNT;
+    }
+    if (getEntry(c) == FAT12_FREE) {
+      setEntry(c, FAT12_EOC);
+      if (prev) {
+        setEntry(prev, c);
+      }
+      freeHint = c + 1;
+      return c;
+    }
+  }
+  return 0;
+}
+
+static void freeChain(uint16_t cluster) {
+  while (isValidCluster(cluster)) {
+    uint16_t next = getEntry(cluster);
+    setEntry(cluster, FAT12_FREE);
+    cluster = next;
+  }
+}
+
+static bool isErased(const uint8_t *buf, uint16_t size) {
+  for (uint16_t i = 0; i < size; ++i) {
+    if (buf[i] != 0xFF) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// =============================
+// Журнал перезаписи erase-блоков
+// =============================
+
+// Пока блок стерт и собирается заново, его копия лежит в служебном
+// секторе (для копии FAT — во второй копии), а адрес — в журнале в
+// резервных секторах тома за загрузочным. Запись журнала программируется
+// сбросом битов: адрес перед стиранием, отметка после сборки. FAT_Init
+// восстанавливает блок, отметки у которого нет.
+#define JOURNAL_ADDR (FAT_BASE_ADDR + FAT_SECTOR_SIZE)
+#define JOURNAL_END (FAT_BASE_ADDR + FAT_RESERVED_SECTORS * FAT_SECTOR_SIZE)
+#define JOURNAL_FREE 0xFFFFFFFF
+#define JOURNAL_DONE 0
+
+typedef struct {
+  uint32_t block;
+  uint32_t done;
+} JournalRecord;
+
+_Static_assert(FAT_SECTORS_PER_FAT * FAT_SECTOR_SIZE == PY25Q16_ERASE_SIZE,
+               "FAT copy must be exactly one erase block");
+
+static uint32_t backupOf(uint32_t block) {
+  if (block == FAT_TABLE_ADDR(0)) {
+    return FAT_TABLE_ADDR(1);
+  }
+  if (block == FAT_TABLE_ADDR(1)) {
+    return FAT_TABLE_ADDR(0);
+  }
+  return FAT_SCRATCH_ADDR;
+}
+
+static bool isJournaledBlock(uint32_t block) {
+  return block % PY25Q16_ERASE_SIZE == 0 && block > FAT_BASE_ADDR &&
+         block < FAT_SCRATCH_ADDR;
+}
+
+static void copyPages(uint32_t dst, uint32_t src, uint32_t size);
+
+// Журнал полон: блок 0 стирается, загрузочный сектор переносится через
+// служебный сектор
+static void journalReset(void) {
+  PY25Q16_SectorErase(FAT_SCRATCH_ADDR);
+  copyPages(FAT_SCRATCH_ADDR, FAT_BASE_ADDR, FAT_SECTOR_SIZE);
+  PY25Q16_SectorErase(FAT_BASE_ADDR);
+  copyPages(FAT_BASE_ADDR, FAT_SCRATCH_ADDR, FAT_SECTOR_SIZE);
+}
+
+// Адрес свободной записи журнала или JOURNAL_END
+static uint32_t journalSlot(bool allowReset) {
+  JournalRecord r;
+  for (uint32_t a = JOURNAL_ADDR; a < JOURNAL_END; a += sizeof(r)) {
+    PY25Q16_ReadBuffer(a, &r, sizeof(r));
+    if (r.block == JOURNAL_FREE && r.done == JOURNAL_FREE) {
+      return a;
+    }
+  }
+  if (!allowReset) {
+    return JOURNAL_END;
+  }
+  journalReset();
+  return JOURNAL_ADDR;
+}
+
+static void journalBegin(uint32_t rec, uint32_t block) {
+  if (rec < JOURNAL_END) {
+    PY25Q16_Program(rec, &block, sizeof(block));
+  }
+}
+
+static void journalEnd(uint32_t rec) {
+  const uint32_t done = JOURNAL_DONE;
+  if (rec < JOURNAL_END) {
+    PY25Q16_Program(rec + sizeof(uint32_t), &done, sizeof(done));
+  }
+}
+
+static void journalRecover(void) {
+  JournalRecord r;
+  for (uint32_t a = JOURNAL_ADDR; a < JOURNAL_END; a += sizeof(r)) {
+    PY25Q16_ReadBuffer(a, &r, sizeof(r));
+    if (r.block == JOURNAL_FREE) {
+      break;
+    }
+    if (r.done != JOURNAL_DONE && isJournaledBlock(r.block)) {
+      printf("Restore block %06X\n", r.block);
+      PY25Q16_SectorErase(r.block);
+      copyPages(r.block, backupOf(r.block), PY25Q16_ERASE_SIZE);
+      journalEnd(a);
+    }
+  }
+}
+
+// =============================
+// Кеш записи MSC
+// =============================
+
+// Сектор можно дописать без стирания: новые данные только сбрасывают биты
+static bool canProgram(uint32_t addr, const uint8_t *buf) {
+  uint8_t old[PY25Q16_PAGE_SIZE];
+  for (uint16_t o = 0; o < FAT_SECTOR_SIZE; o += PY25Q16_PAGE_SIZE) {
+    PY25Q16_ReadBuffer(addr + o, old, PY25Q16_PAGE_SIZE);
+    for (uint16_t i = 0; i < PY25Q16_PAGE_SIZE; ++i) {
+      if ((old[i] & buf[o + i]) != buf[o + i]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static void copyPages(uint32_t dst, uint32_t src, uint32_t size) {
+  uint8_t page[PY25Q16_PAGE_SIZE];
+  for (uint32_t o = 0; o < size; o += PY25Q16_PAGE_SIZE) {
+    PY25Q16_ReadBuffer(src + o, page, PY25Q16_PAGE_SIZE);
+    if (!isErased(page, PY25Q16_PAGE_SIZE)) {
+      PY25Q16_Program(dst + o, page, PY25Q16_PAGE_SIZE);
+    }
+  }
+}
+
+// Запись MSC идет из прерывания USB и пользуется служебным сектором и
+// fatTable. Операции прошивки над ними целиком выполняются с замаскированным
+// USB; вложенные вызовы восстанавливают прежнее состояние
+static uint32_t usbHold(void) {
+  uint32_t enabled = NVIC_GetEnableIRQ(USB_IRQn);
+  NVIC_DisableIRQ(USB_IRQn);
+  return enabled;
+}
+
+static void usbRelease(uint32_t enabled) {
+  if (enabled) {
+    NVIC_EnableIRQ(USB_IRQn);
+  }
+}
+
+// Собирает блок в служебном секторе (недостающие LBA берутся из
+// целевого), затем одно стирание и перенос обратно.
+static void wbFlush(void) {
+  if (wbBlock == WB_NONE) {
+    return;
+  }
+
+  uint32_t usb = usbHold();
+  for (uint8_t i = 0; i < PY25Q16_ERASE_SIZE / FAT_SECTOR_SIZE; ++i) {
+    if (!(wbStaged & (1 << i))) {
+      uint32_t o = i * FAT_SECTOR_SIZE;
+      copyPages(FAT_SCRATCH_ADDR + o, wbBlock + o, FAT_SECTOR_SIZE);
+    }
+  }
+  // Служебный сектор занят: журнал здесь не сбрасывается, при заполненном
+  // журнале блок переносится без защиты
+  uint32_t rec = wbBlock != FAT_BASE_ADDR ? journalSlot(false) : JOURNAL_END;
+  journalBegin(rec, wbBlock);
+  PY25Q16_SectorErase(wbBlock);
+  copyPages(wbBlock, FAT_SCRATCH_ADDR, PY25Q16_ERASE_SIZE);
+  journalEnd(rec);
+
+  if (wbBlock < FAT_ROOT_ADDR) {
+    fatLoaded = false;
+  }
+  wbBlock = WB_NONE;
+  wbStaged = 0;
+  usbRelease(usb);
+}
+
+// Где сейчас лежат данные LBA: отложенные — в служебном секторе
+static uint32_t readAddr(uint32_t lba) {
+  uint32_t addr = FAT_BASE_ADDR + lba * FAT_SECTOR_SIZE;
+  uint32_t offset = addr % PY25Q16_ERASE_SIZE;
+
+  if (addr - offset == wbBlock &&
+      (wbStaged & (1 << (offset / FAT_SECTOR_SIZE)))) {
+    return FAT_SCRATCH_ADDR + offset;
+  }
+  return addr;
 }
 
 void FAT_ReadBlock(uint32_t lba, uint8_t *buf) {
-  uint32_t addr = lba * FAT_SECTOR_SIZE;
-  PY25Q16_ReadBuffer(addr, buf, FAT_SECTOR_SIZE);
+  PY25Q16_ReadBuffer(readAddr(lba), buf, FAT_SECTOR_SIZE);
+}
+
+void FAT_ReadBlockStart(uint32_t lba, uint8_t *buf) {
+  PY25Q16_ReadAsync(readAddr(lba), buf, FAT_SECTOR_SIZE);
 }
 
 void FAT_WriteBlock(uint32_t lba, const uint8_t *buf) {
-  uint32_t addr = lba * FAT_SECTOR_SIZE;
+  uint32_t addr = FAT_BASE_ADDR + lba * FAT_SECTOR_SIZE;
+  uint32_t offset = addr % PY25Q16_ERASE_SIZE;
+  uint32_t block = addr - offset;
+  uint8_t bit = 1 << (offset / FAT_SECTOR_SIZE);
+
+  // Хост поменял FAT — кеш таблицы перечитаем при следующем обращении.
+  // Выделения прошивки (запись в файл идет между FAT_Sync) сначала уходят
+  // на флеш, а дозапись открытых файлов прекращается
+  if (lba < FAT_ROOT_DIR_SECTOR) {
+    if (fatDirty) {
+      wbFlush();
+      syncTable();
+    }
+    fatLoaded = false;
+    fatGen++;
+  }
+
+  if (block != wbBlock) {
+    wbFlush();
+  }
+
+  if (wbStaged & bit) {
+    // LBA уже отложен: переписываем слот, если хватает сброса битов,
+    // иначе сбрасываем блок и откладываем заново
+    if (canProgram(FAT_SCRATCH_ADDR + offset, buf)) {
+      PY25Q16_Program(FAT_SCRATCH_ADDR + offset, buf, FAT_SECTOR_SIZE);
+      wbTime = Now();
+      return;
+    }
+    wbFlush();
+  }
+
+  // Стертое место (свежий кластер) пишется сразу, без стирания
+  if (canProgram(addr, buf)) {
+    PY25Q16_Program(addr, buf, FAT_SECTOR_SIZE);
+    return;
+  }
+
+  if (wbBlock == WB_NONE) {
+    PY25Q16_SectorErase(FAT_SCRATCH_ADDR);
+    wbBlock = block;
+    wbStaged = 0;
+  }
+  PY25Q16_Program(FAT_SCRATCH_ADDR + offset, buf, FAT_SECTOR_SIZE);
+  wbStaged |= bit;
+  wbTime = Now();
+}
+
+void FAT_Flush(void) { wbFlush(); }
+
+void FAT_Update(void) {
+  if (wbBlock != WB_NONE && Now() - wbTime >= FAT_WB_IDLE_MS) {
+    wbFlush();
+  }
+}
+
+// Перезапись erase-блока без 4 КБ буфера в RAM: блок копируется в
+// служебный сектор, стирается и собирается обратно постранично через edit.
+// Копия FAT собирается из второй копии, служебный сектор не нужен
+static void rewriteBlock(uint32_t block,
+                         void (*edit)(uint32_t addr, uint8_t *page)) {
+  uint8_t page[PY25Q16_PAGE_SIZE];
+
+  wbFlush(); // служебный сектор занят отложенной записью хоста
 
-  // Если адрес выровнен на границу сектора флеш (4KB), стираем сектор
-  /* if ((addr % 4096) == 0) {
-    PY25Q16_SectorErase(addr);
-  } */
+  uint32_t rec = journalSlot(true);
+  uint32_t backup = backupOf(block);
+  if (backup == FAT_SCRATCH_ADDR) {
+    PY25Q16_SectorErase(FAT_SCRATCH_ADDR);
+    copyPages(FAT_SCRATCH_ADDR, block, PY25Q16_ERASE_SIZE);
+  }
+  journalBegin(rec, block);
+
+  PY25Q16_SectorErase(block);
+  for (uint32_t o = 0; o < PY25Q16_ERASE_SIZE; o += PY25Q16_PAGE_SIZE) {
+    PY25Q16_ReadBuffer(backup + o, page, PY25Q16_PAGE_SIZE);
+    edit(block + o, page);
+    if (!isErased(page, PY25Q16_PAGE_SIZE)) {
+      PY25Q16_Program(block + o, page, PY25Q16_PAGE_SIZE);
+    }
+  }
+  journalEnd(rec);
+}
 
-  PY25Q16_WriteBuffer(addr, buf, FAT_SECTOR_SIZE, false);
+static uint32_t metaAddr;
+static const uint8_t *metaData;
+static uint16_t metaSize;
+
+static void editMeta(uint32_t addr, uint8_t *page) {
+  for (uint16_t i = 0; i < PY25Q16_PAGE_SIZE; ++i) {
+    if (addr + i >= metaAddr && addr + i < metaAddr + metaSize) {
+      page[i] = metaData[addr + i - metaAddr];
+    }
+  }
+}
+
+// Запись метаданных: если нужные биты только сбрасываются — простое
+// программирование, иначе перезапись erase-блока
+static void writeMeta(uint32_t addr, const void *data, uint16_t size) {
+  uint8_t buf[PY25Q16_PAGE_SIZE];
+  const uint8_t *src = data;
+  bool erase = false;
+  bool changed = false;
+
+  for (uint16_t o = 0; o < size && !erase; o += PY25Q16_PAGE_SIZE) {
+    uint16_t n = MIN(size - o, PY25Q16_PAGE_SIZE);
+    PY25Q16_ReadBuffer(addr + o, buf, n);
+    for (uint16_t i = 0; i < n; ++i) {
+      if ((buf[i] & src[o + i]) != src[o + i]) {
+        erase = true;
+        break;
+      }
+      changed |= buf[i] != src[o + i];
+    }
+  }
+
+  if (!erase) {
+    if (changed) {
+      PY25Q16_Program(addr, data, size);
+    }
+    return;
+  }
+
+  metaAddr = addr;
+  metaData = data;
+  metaSize = size;
+  for (uint32_t block = addr - addr % PY25Q16_ERASE_SIZE; block < addr + size;
+       block += PY25Q16_ERASE_SIZE) {
+    rewriteBlock(block, editMeta);
+  }
+}
+
+static int16_t findDirEntry(const char name[11], bool freeSlot,
+                            fat_dir_entry_t *e) {
+  for (uint16_t i = 0; i < FAT_ROOT_ENTRIES; ++i) {
+    PY25Q16_ReadBuffer(dirEntryAddr(i), e, sizeof(fat_dir_entry_t));
+    if (e->name[0] == 0x00) {
+      return freeSlot ? i : -1; // конец каталога
+    }
+    if (freeSlot ? e->name[0] == 0xE5
+                 : !(e->attr & (FAT_ATTR_VOLUME_ID | FAT_ATTR_DIRECTORY)) &&
+                       memcmp(e->name, name, 11) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static void syncTable(void) {
+  if (!fatDirty) {
+    return;
+  }
+  for (uint8_t n = 0; n < FAT_NUM_FATS; ++n) {
+    writeMeta(FAT_TABLE_ADDR(n), fatTable, FAT12_BYTES);
+  }
+  fatDirty = false;
+}
+
+static bool fileExists(const char name[11]) {
+  fat_dir_entry_t e;
+  wbFlush();
+  return findDirEntry(name, false, &e) >= 0;
+}
+
+static bool fileStat(const char name[11], fat_dir_entry_t *e) {
+  wbFlush();
+  return findDirEntry(name, false, e) >= 0;
+}
+
+static bool readDir(uint16_t *index, fat_dir_entry_t *e) {
+  if (*index == 0) {
+    wbFlush();
+  }
+  while (*index < FAT_ROOT_ENTRIES) {
+    PY25Q16_ReadBuffer(dirEntryAddr((*index)++), e, sizeof(fat_dir_entry_t));
+    if (e->name[0] == 0x00) {
+      *index = FAT_ROOT_ENTRIES; // конец каталога
+      return false;
+    }
+    if (e->name[0] != 0xE5 &&
+        !(e->attr & (FAT_ATTR_VOLUME_ID | FAT_ATTR_DIRECTORY))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static int16_t pinFile(const char name[11], uint16_t cluster, uint16_t count,
+                       uint32_t size) {
+  fat_dir_entry_t e;
+
+  wbFlush();
+  loadTable();
+
+  int16_t slot = findDirEntry(name, false, &e);
+  if (slot < 0) {
+    slot = findDirEntry(name, true, &e);
+    if (slot < 0) {
+      return -1;
+    }
+    memset(&e, 0, sizeof(fat_dir_entry_t));
+    memcpy(e.name, name, 11);
+    e.attr = FAT_ATTR_ARCHIVE;
+    e.crt_date = 0x4E21;
+    e.lst_acc_date = 0x4E21;
+    e.wrt_date = 0x4E21;
+  } else if (e.fst_clus_lo != cluster) {
+    freeChain(e.fst_clus_lo); // файл, записанный хостом поверх
+  }
+
+  for (uint16_t i = 0; i < count; ++i) {
+    uint16_t c = cluster + i;
+    uint16_t next = i + 1 < count ? c + 1 : FAT12_EOC;
+    uint16_t cur = getEntry(c);
+    if (cur == next) {
+      continue;
+    }
+    if (next == FAT12_EOC && isValidCluster(cur)) {
+      freeChain(cur); // хвост от прежнего размера
+    }
+    setEntry(c, next);
+  }
+
+  e.fst_clus_lo = cluster;
+  e.file_size = size;
+  writeMeta(dirEntryAddr(slot), &e, sizeof(fat_dir_entry_t));
+  syncTable();
+  return slot;
+}
+
+// Хвост последнего кластера после конца файла должен быть стертым,
+// иначе дозапись программированием невозможна
+static uint32_t tailCut;
+
+static void editTail(uint32_t addr, uint8_t *page) {
+  for (uint16_t i = 0; i < PY25Q16_PAGE_SIZE; ++i) {
+    if (addr + i >= tailCut) {
+      page[i] = 0xFF;
+    }
+  }
+}
+
+static void prepareTail(FAT_File *f) {
+  uint32_t offset = f->entry.file_size % FAT_CLUSTER_SIZE;
+  if (!offset) {
+    return;
+  }
+  uint32_t base = clusterAddr(f->cluster);
+  for (uint32_t o = offset; o < FAT_CLUSTER_SIZE;) {
+    uint16_t n = MIN(FAT_CLUSTER_SIZE - o, PY25Q16_PAGE_SIZE);
+    PY25Q16_ReadBuffer(base + o, f->page, n);
+    if (!isErased(f->page, n)) {
+      tailCut = base + offset;
+      rewriteBlock(base, editTail);
+      break;
+    }
+    o += n;
+  }
+}
+
+static bool openFile(FAT_File *f, const char name[11], bool create) {
+  wbFlush();
+  loadTable();
+  memset(f, 0, sizeof(FAT_File));
+
+  int16_t slot = findDirEntry(name, false, &f->entry);
+  if (slot < 0) {
+    if (!create) {
+      return false;
+    }
+    slot = findDirEntry(name, true, &f->entry);
+    if (slot < 0) {
+      return false;
+    }
+    memset(&f->entry, 0, sizeof(fat_dir_entry_t));
+    memcpy(f->entry.name, name, 11);
+    f->entry.attr = FAT_ATTR_ARCHIVE;
+    f->entry.crt_date = 0x4E21;
+    f->entry.lst_acc_date = 0x4E21;
+    f->entry.wrt_date = 0x4E21;
+    // Сразу занимаем слот каталога
+    writeMeta(dirEntryAddr(slot), &f->entry, sizeof(fat_dir_entry_t));
+  }
+
+  f->dirIndex = slot;
+  f->readCluster = f->entry.fst_clus_lo;
+  f->gen = fatGen;
+
+  if (!f->entry.file_size && f->entry.fst_clus_lo) {
+    freeChain(f->entry.fst_clus_lo);
+    f->entry.fst_clus_lo = 0;
+    f->dirty = true;
+  }
+
+  // Кластер с концом файла — туда идет дозапись; дальше по цепочке может
+  // лежать запас, оставшийся от незакрытого файла
+  uint16_t c = f->entry.fst_clus_lo;
+  for (uint32_t n = f->entry.file_size;
+       n > FAT_CLUSTER_SIZE && isValidCluster(getEntry(c));
+       n -= FAT_CLUSTER_SIZE) {
+    c = getEntry(c);
+  }
+  f->cluster = c;
+  f->fill = f->entry.file_size % PY25Q16_PAGE_SIZE;
+  memset(f->page, 0xFF, PY25Q16_PAGE_SIZE);
+  return true;
+}
+
+static void flushPage(FAT_File *f) {
+  uint32_t start = f->entry.file_size - f->fill;
+  PY25Q16_Program(clusterAddr(f->cluster) + start % FAT_CLUSTER_SIZE, f->page,
+                  f->fill);
+  // Запрограммированное не трогаем повторно
+  memset(f->page, 0xFF, f->fill);
+  if (f->fill == PY25Q16_PAGE_SIZE) {
+    f->fill = 0;
+  }
+}
+
+// Следующий кластер дозаписи: из запаса цепочки, иначе новый запас из
+// FAT_PREALLOC кластеров. Выделение ставит биты FAT12 и требует
+// перезаписи копий FAT, запас делает ее редкой
+static uint16_t nextCluster(FAT_File *f) {
+  uint16_t prev = 0;
+  if (f->entry.fst_clus_lo) {
+    uint16_t next = getEntry(f->cluster);
+    if (isValidCluster(next)) {
+      return next;
+    }
+    prev = f->cluster;
+  }
+  uint16_t first = 0;
+  for (uint8_t i = 0; i < FAT_PREALLOC; ++i) {
+    uint16_t c = allocCluster(prev);
+    if (!c) {
+      break;
+    }
+    if (!first) {
+      first = c;
+    }
+    prev = c;
+  }
+  return first;
+}
+
+static bool appendFile(FAT_File *f, const void *buf, uint32_t size) {
+  const uint8_t *p = buf;
+
+  if (f->gen != fatGen) {
+    return false; // хост переписал FAT после открытия
+  }
+
+  if (!f->appending) {
+    f->appending = true;
+    prepareTail(f);
+    memset(f->page, 0xFF, PY25Q16_PAGE_SIZE);
+  }
+
+  while (size) {
+    if (f->entry.file_size % FAT_CLUSTER_SIZE == 0 && f->fill == 0) {
+      // Новый кластер стирается целиком до первой страницы
+      uint16_t c = nextCluster(f);
+      if (!c) {
+        return false;
+      }
+      if (!f->entry.fst_clus_lo) {
+        f->entry.fst_clus_lo = c;
+        f->readCluster = c;
+      }
+      f->cluster = c;
+      PY25Q16_SectorErase(clusterAddr(c));
+    }
+
+    uint16_t n = MIN(size, (uint32_t)(PY25Q16_PAGE_SIZE - f->fill));
+    memcpy(f->page + f->fill, p, n);
+    f->fill += n;
+    f->entry.file_size += n;
+    f->dirty = true;
+    p += n;
+    size -= n;
+
+    if (f->fill == PY25Q16_PAGE_SIZE) {
+      flushPage(f);
+    }
+  }
+  return true;
+}
+
+static uint32_t readFile(FAT_File *f, void *buf, uint32_t size) {
+  uint8_t *p = buf;
+  uint32_t done = 0;
+
+  if (size > f->entry.file_size - f->pos) {
+    size = f->entry.file_size - f->pos;
+  }
+
+  while (done < size) {
+    uint32_t offset = f->pos % FAT_CLUSTER_SIZE;
+    if (offset == 0 && f->pos) {
+      uint16_t next = getEntry(f->readCluster);
+      if (!isValidCluster(next)) {
+        break;
+      }
+      f->readCluster = next;
+    }
+    uint32_t n = MIN(size - done, FAT_CLUSTER_SIZE - offset);
+    PY25Q16_ReadBuffer(clusterAddr(f->readCluster) + offset, p + done, n);
+    done += n;
+    f->pos += n;
+  }
+  return done;
+}
+
+static void syncFile(FAT_File *f) {
+  if (f->fill) {
+    flushPage(f);
+  }
+  syncTable();
+  if (f->dirty) {
+    writeMeta(dirEntryAddr(f->dirIndex), &f->entry, sizeof(fat_dir_entry_t));
+    f->dirty = false;
+  }
+}
+
+// =============================
+// API: USB замаскирован на всю операцию
+// =============================
+
+bool FAT_Exists(const char name[11]) {
+  uint32_t usb = usbHold();
+  bool ok = fileExists(name);
+  usbRelease(usb);
+  return ok;
+}
+
+bool FAT_Stat(const char name[11], fat_dir_entry_t *e) {
+  uint32_t usb = usbHold();
+  bool ok = fileStat(name, e);
+  usbRelease(usb);
+  return ok;
+}
+
+bool FAT_ReadDir(uint16_t *index, fat_dir_entry_t *e) {
+  uint32_t usb = usbHold();
+  bool ok = readDir(index, e);
+  usbRelease(usb);
+  return ok;
+}
+
+int16_t FAT_Pin(const char name[11], uint16_t cluster, uint16_t count,
+                uint32_t size) {
+  uint32_t usb = usbHold();
+  int16_t slot = pinFile(name, cluster, count, size);
+  usbRelease(usb);
+  return slot;
+}
+
+bool FAT_Open(FAT_File *f, const char name[11], bool create) {
+  uint32_t usb = usbHold();
+  bool ok = openFile(f, name, create);
+  usbRelease(usb);
+  return ok;
+}
+
+bool FAT_Append(FAT_File *f, const void *buf, uint32_t size) {
+  uint32_t usb = usbHold();
+  bool ok = appendFile(f, buf, size);
+  usbRelease(usb);
+  return ok;
+}
+
+uint32_t FAT_Read(FAT_File *f, void *buf, uint32_t size) {
+  uint32_t usb = usbHold();
+  uint32_t done = readFile(f, buf, size);
+  usbRelease(usb);
+  return done;
+}
+
+void FAT_Sync(FAT_File *f) {
+  uint32_t usb = usbHold();
+  syncFile(f);
+  usbRelease(usb);
+}
+
+void FAT_Close(FAT_File *f) {
+  uint32_t usb = usbHold();
+  // Неиспользованный запас возвращается: освобождение только сбрасывает
+  // биты, перезаписывается лишь запись конца цепочки
+  uint16_t tail = f->entry.fst_clus_lo ? getEntry(f->cluster) : 0;
+  if (f->gen == fatGen && isValidCluster(tail)) {
+    freeChain(tail);
+    setEntry(f->cluster, FAT12_EOC);
+  }
+  syncFile(f);
+  usbRelease(usb);
 }
@@ -1,28 +1,41 @@
 #ifndef FAT_FS_H
 #define FAT_FS_H
 
+#include "py25q16.h"
 #include <stdint.h>
 #include <stdbool.h>
 
-// FAT12 configuration for 2MB flash (cluster count ~505, <4085 = FAT12)
+// FAT12 configuration for the SPI flash above the settings/channels area.
+// Первые 256 КБ заняты EEPROM-эмуляцией, последний erase-блок — служебный
+// (буфер для перезаписи метаданных).
+#define FAT_BASE_ADDR (256 * 1024)
+#define FAT_SCRATCH_ADDR PY25Q16_SCRATCH_ADDR
+
+// Через сколько мс простоя кеш записи MSC сбрасывается на флеш
+#define FAT_WB_IDLE_MS 1000
+
+// Сколько кластеров файл занимает за раз при дозаписи; остаток запаса
+// освобождается в FAT_Close
+#define FAT_PREALLOC 16
+
 #define FAT_SECTOR_SIZE 512
-#define FAT_SECTORS_PER_CLUSTER 8  // 4KB cluster
-#define FAT_RESERVED_SECTORS 1
+#define FAT_SECTORS_PER_CLUSTER 8  // 4KB cluster = erase block
+#define FAT_RESERVED_SECTORS 8  // data area aligned to erase block
 #define FAT_NUM_FATS 2  // Change to 2 for standard redundancy
 #define FAT_ROOT_ENTRIES 512
-#define FAT_TOTAL_SECTORS 4096  // 2MB / 512 bytes
+#define FAT_TOTAL_SECTORS ((FAT_SCRATCH_ADDR - FAT_BASE_ADDR) / FAT_SECTOR_SIZE)  // 3576
 
 // Calculated parameters
 #define FAT_ROOT_DIR_SECTORS ((FAT_ROOT_ENTRIES * 32 + FAT_SECTOR_SIZE - 1) / FAT_SECTOR_SIZE)  // 32
 #define FAT_SECTORS_PER_FAT 8  // Change to 8 (total FAT: 16 sectors; enough for ~2048 clusters max)
+#define FAT_CLUSTER_SIZE (FAT_SECTOR_SIZE * FAT_SECTORS_PER_CLUSTER)
 
 // Offsets
 #define FAT_BOOT_SECTOR 0
 #define FAT_TABLE_SECTOR (FAT_BOOT_SECTOR + FAT_RESERVED_SECTORS)
 #define FAT_ROOT_DIR_SECTOR (FAT_TABLE_SECTOR + (FAT_NUM_FATS * FAT_SECTORS_PER_FAT))
 #define FAT_DATA_SECTOR (FAT_ROOT_DIR_SECTOR + FAT_ROOT_DIR_SECTORS)
-
-
+#define FAT_CLUSTER_COUNT ((FAT_TOTAL_SECTORS - FAT_DATA_SECTOR) / FAT_SECTORS_PER_CLUSTER)  // 440
 
 // FAT Entry типы
 #define FAT_FREE_CLUSTER 0x0000
@@ -30,6 +43,10 @@
 #define FAT_BAD_CLUSTER 0xFFF7
 #define FAT_EOC 0xFFFF  // End of chain
 
+// FAT12 значения
+#define FAT12_FREE 0x000
+#define FAT12_EOC 0xFFF
+
 // Атрибуты файлов
 #define FAT_ATTR_READ_ONLY 0x01
 #define FAT_ATTR_HIDDEN 0x02
@@ -80,10 +97,51 @@ typedef struct __attribute__((packed)) {
     uint32_t file_size;
 } fat_dir_entry_t;
 
+// Файл в корневом каталоге.
+// Запись только в конец: новый кластер стирается целиком, дальше страницы
+// программируются без стирания. FAT (кеш в RAM) и запись каталога
+// попадают на флеш только в FAT_Sync/FAT_Close; до закрытия цепочка
+// может быть длиннее файла на запас (FAT_PREALLOC). После записи FAT хостом
+// FAT_Append отказывает: файл надо закрыть.
+typedef struct {
+  fat_dir_entry_t entry; // копия записи каталога, file_size с учетом буфера
+  uint32_t pos;          // позиция чтения
+  uint16_t dirIndex;
+  uint16_t readCluster;  // кластер, содержащий pos
+  uint16_t cluster;      // последний кластер цепочки
+  uint16_t fill;         // байт в текущей странице
+  bool dirty;
+  bool appending;
+  uint8_t gen;           // поколение FAT при открытии
+  uint8_t page[PY25Q16_PAGE_SIZE];
+} FAT_File;
+
 // Публичные функции
 void FAT_Init(void);
+bool FAT_IsReady(void);
 void FAT_Format(void);
 void FAT_ReadBlock(uint32_t lba, uint8_t *buf);
+// Чтение LBA через DMA без ожидания, завершение — PY25Q16_ReadWait
+void FAT_ReadBlockStart(uint32_t lba, uint8_t *buf);
 void FAT_WriteBlock(uint32_t lba, const uint8_t *buf);
+void FAT_Flush(void);
+void FAT_Update(void);
+
+bool FAT_Exists(const char name[11]);
+bool FAT_Stat(const char name[11], fat_dir_entry_t *e);
+// Перебор файлов корневого каталога за один проход: следующая запись с
+// *index (начинать с 0), *index сдвигается за нее. false — конец каталога
+bool FAT_ReadDir(uint16_t *index, fat_dir_entry_t *e);
+bool FAT_Open(FAT_File *f, const char name[11], bool create);
+uint32_t FAT_Read(FAT_File *f, void *buf, uint32_t size);
+bool FAT_Append(FAT_File *f, const void *buf, uint32_t size);
+void FAT_Sync(FAT_File *f);
+void FAT_Close(FAT_File *f);
+
+// Закрепляет за файлом непрерывную цепочку кластеров (виртуальные файлы).
+// Каталог и FAT переписываются только при расхождении. Возвращает индекс
+// записи каталога или -1
+int16_t FAT_Pin(const char name[11], uint16_t cluster, uint16_t count,
+                uint32_t size);
 
 #endif // FAT_FS_H
@@ -1,6 +1,5 @@
 #include "i2c.h"
 #include "gpio.h"
-#include "systick.h"
 
 #define PIN_SCL GPIO_MAKE_PIN(GPIOF, LL_GPIO_PIN_5)
 #define PIN_SDA GPIO_MAKE_PIN(GPIOF, LL_GPIO_PIN_6)
@@ -20,26 +19,35 @@ static inline void SDA_SetDir(bool Output) {
 
 static inline bool SDA_IsSet() { return GPIO_IsInputPinSet(PIN_SDA); }
 
+// Полупериод SCL без SysTick: SYSTICK_DelayUs(1) на каждом фронте стоил
+// несколько мкс. ~1 мкс при 48 МГц, вместе с обращениями к GPIO ~350 кГц
+#define I2C_DELAY_LOOPS 6
+
+static inline void I2C_Delay() {
+  for (volatile uint8_t i = 0; i < I2C_DELAY_LOOPS; i++) {
+  }
+}
+
 void I2C_Start(void) {
   SDA_Set();
-  SYSTICK_DelayUs(1);
+  I2C_Delay();
   SCL_Set();
-  SYSTICK_DelayUs(1);
+  I2C_Delay();
   SDA_Reset();
-  SYSTICK_DelayUs(1);
+  I2C_Delay();
   SCL_Reset();
-  SYSTICK_DelayUs(1);
+  I2C_Delay();
 }
 
 void I2C_Stop(void) {
   SDA_Reset();
-  SYSTICK_DelayUs(1);
+  I2C_Delay();
   SCL_Reset();
-  SYSTICK_DelayUs(1);
+  I2C_Delay();
   SCL_Set();
-  SYSTICK_DelayUs(1);
+  I2C_Delay();
   SDA_Set();
-  SYSTICK_DelayUs(1);
+  I2C_Delay();
 }
 
 uint8_t I2C_Read(bool bFinal) {
@@ -50,31 +58,30 @@ uint8_t I2C_Read(bool bFinal) {
   Data = 0;
   for (i = 0; i < 8; i++) {
     SCL_Reset();
-    SYSTICK_DelayUs(1);
+    I2C_Delay();
     SCL_Set();
-    SYSTICK_DelayUs(1);
+    I2C_Delay();
     Data <<= 1;
-    SYSTICK_DelayUs(1);
     if (SDA_IsSet()) {
       Data |= 1U;
     }
     SCL_Reset();
-    SYSTICK_DelayUs(1);
+    I2C_Delay();
   }
 
   SDA_SetDir(true);
   SCL_Reset();
-  SYSTICK_DelayUs(1);
+  I2C_Delay();
   if (bFinal) {
     SDA_Set();
   } else {
     SDA_Reset();
   }
-  SYSTICK_DelayUs(1);
+  I2C_Delay();
   SCL_Set();
-  SYSTICK_DelayUs(1);
+  I2C_Delay();
   SCL_Reset();
-  SYSTICK_DelayUs(1);
+  I2C_Delay();
 
   return Data;
 }
@@ -84,7 +91,7 @@ int I2C_Write(uint8_t Data) {
   int ret = -1;
 
   SCL_Reset();
-  SYSTICK_DelayUs(1);
+  I2C_Delay();
   for (i = 0; i < 8; i++) {
     if ((Data & 0x80) == 0) {
       SDA_Reset();
@@ -92,18 +99,18 @@ int I2C_Write(uint8_t Data) {
       SDA_Set();
     }
     Data <<= 1;
-    SYSTICK_DelayUs(1);
+    I2C_Delay();
     SCL_Set();
-    SYSTICK_DelayUs(1);
+    I2C_Delay();
     SCL_Reset();
-    SYSTICK_DelayUs(1);
+    I2C_Delay();
   }
 
   SDA_SetDir(false);
   SDA_Set();
-  SYSTICK_DelayUs(1);
+  I2C_Delay();
   SCL_Set();
-  SYSTICK_DelayUs(1);
+  I2C_Delay();
 
   for (i = 0; i < 255; i++) {
     if (!SDA_IsSet()) {
@@ -113,7 +120,7 @@ int I2C_Write(uint8_t Data) {
   }
 
   SCL_Reset();
-  SYSTICK_DelayUs(1);
+  I2C_Delay();
   SDA_SetDir(true);
   SDA_Set();
 
@@ -125,11 +132,9 @@ int I2C_ReadBuffer(void *pBuffer, uint8_t Size) {
   uint8_t i;
 
   for (i = 0; i < Size - 1; i++) {
-    SYSTICK_DelayUs(1);
     pData[i] = I2C_Read(false);
   }
 
-  SYSTICK_DelayUs(1);
   pData[i] = I2C_Read(true);
 
   return Size;
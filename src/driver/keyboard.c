@@ -4,6 +4,9 @@
 // ============================================================================
 
 #include "keyboard.h"
+#include "../external/PY32F071_HAL_Driver/Inc/py32f071_ll_bus.h"
+#include "../external/PY32F071_HAL_Driver/Inc/py32f071_ll_exti.h"
+#include "../external/PY32F071_HAL_Driver/Inc/py32f071_ll_tim.h"
 #include "gpio.h"
 #include "systick.h"
 
@@ -25,11 +28,31 @@ typedef struct {
   bool physical_state; // Текущее физическое состояние
 } key_context_t;
 
+// Событие в очереди: пишет прерывание таймера, читает главный цикл
+typedef struct {
+  uint8_t key;
+  uint8_t event;
+} key_queue_item_t;
+
 // Глобальные переменные
 static key_context_t g_keys[KEY_COUNT];
 static key_event_callback_t g_callback;
 static key_timing_config_t g_timing;
 
+static key_queue_item_t g_queue[KEYBOARD_QUEUE_SIZE];
+static volatile uint8_t g_queue_head;
+static volatile uint8_t g_queue_tail;
+
+// Таймер опроса: 1 мс, работает только пока есть нажатые кнопки
+#define KBD_TIM TIM7
+#define KBD_TIM_IRQn TIM7_IRQn
+#define KBD_IRQ_PRIORITY 2
+
+// Строки матрицы и PTT будят клавиатуру по спаду
+#define EXTI_LINES                                                             \
+  (LL_EXTI_LINE_15 | LL_EXTI_LINE_14 | LL_EXTI_LINE_13 | LL_EXTI_LINE_12 |     \
+   LL_EXTI_LINE_10)
+
 // GPIO конфигурация
 #define GPIOx GPIOB
 #define PIN_MASK_COLS                                                          \
@@ -100,6 +123,21 @@ static KEY_Code_t scan_matrix(void) {
 
 static bool scan_ptt(void) { return GPIO_IsPttPressed(); }
 
+// ============================================================================
+// Очередь событий
+// ============================================================================
+
+static void push_event(KEY_Code_t key, KEY_State_t event) {
+  uint8_t next = (g_queue_head + 1) & (KEYBOARD_QUEUE_SIZE - 1);
+  if (next == g_queue_tail) {
+    // Главный цикл не успевает — событие теряется
+    return;
+  }
+  g_queue[g_queue_head].key = key;
+  g_queue[g_queue_head].event = event;
+  g_queue_head = next;
+}
+
 // ============================================================================
 // FSM обработка
 // ============================================================================
@@ -123,9 +161,7 @@ static void process_key_fsm(KEY_Code_t key, bool is_pressed) {
       // Дребезг прошёл - кнопка действительно нажата
       ctx->state = STATE_PRESSED;
       ctx->counter = 0;
-      if (g_callback) {
-        g_callback(key, KEY_EVENT_PRESS);
-      }
+      push_event(key, KEY_EVENT_PRESS);
 
       // Переход к ожиданию удержания
       if (g_timing.hold_delay_ms > 0) {
@@ -149,9 +185,7 @@ static void process_key_fsm(KEY_Code_t key, bool is_pressed) {
       // Кнопка удерживается достаточно долго
       ctx->state = STATE_HOLD;
       ctx->counter = 0;
-      if (g_callback) {
-        g_callback(key, KEY_EVENT_HOLD);
-      }
+      push_event(key, KEY_EVENT_HOLD);
 
       // Если включен автоповтор
       if (g_timing.repeat_enabled) {
@@ -173,9 +207,7 @@ static void process_key_fsm(KEY_Code_t key, bool is_pressed) {
       ctx->counter = 0;
     } else if (++ctx->counter >= g_timing.repeat_delay_ms) {
       ctx->counter = 0;
-      if (g_callback) {
-        g_callback(key, KEY_EVENT_REPEAT);
-      }
+      push_event(key, KEY_EVENT_REPEAT);
     }
     break;
 
@@ -187,9 +219,7 @@ static void process_key_fsm(KEY_Code_t key, bool is_pressed) {
       // Кнопка действительно отпущена
       ctx->state = STATE_IDLE;
       ctx->counter = 0;
-      if (g_callback) {
-        g_callback(key, KEY_EVENT_RELEASE);
-      }
+      push_event(key, KEY_EVENT_RELEASE);
     }
     break;
   }
@@ -197,6 +227,93 @@ static void process_key_fsm(KEY_Code_t key, bool is_pressed) {
   ctx->physical_state = is_pressed;
 }
 
+static void keyboard_tick(void) {
+  // Сканировать матрицу
+  KEY_Code_t matrix_key = scan_matrix();
+
+  // Обработать все клавиши матрицы
+  for (uint8_t col = 0; col < 5; col++) {
+    for (uint8_t row = 0; row < 4; row++) {
+      KEY_Code_t key = g_keymap[col][row];
+      if (key != KEY_NONE) {
+        bool is_pressed = (key == matrix_key);
+        process_key_fsm(key, is_pressed);
+      }
+    }
+  }
+
+  // Обработать PTT отдельно
+  bool ptt_pressed = scan_ptt();
+  process_key_fsm(KEY_PTT, ptt_pressed);
+}
+
+static bool all_idle(void) {
+  for (uint8_t i = 0; i < KEY_COUNT; i++) {
+    if (g_keys[i].state != STATE_IDLE) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// ============================================================================
+// Прерывания: EXTI будит, таймер ведёт FSM до отпускания всех кнопок
+// ============================================================================
+
+static void kbd_wake(void) {
+  LL_EXTI_DisableIT(EXTI_LINES);
+  LL_TIM_SetCounter(KBD_TIM, 0);
+  LL_TIM_EnableCounter(KBD_TIM);
+}
+
+static void kbd_sleep(void) {
+  LL_TIM_DisableCounter(KBD_TIM);
+
+  // Все колонки в LOW: любая кнопка матрицы тянет свою строку вниз
+  GPIO_ResetOutputPin(PIN_COLS);
+  LL_EXTI_ClearFlag(EXTI_LINES);
+  LL_EXTI_EnableIT(EXTI_LINES);
+
+  // Нажатие между последним сканом и включением EXTI фронта не даст
+  if (read_rows() != PIN_MASK_ROWS || scan_ptt()) {
+    kbd_wake();
+  }
+}
+
+static void hw_init(void) {
+  LL_APB1_GRP1_EnableClock(LL_APB1_GRP1_PERIPH_TIM7);
+  LL_TIM_SetPrescaler(KBD_TIM, 48 - 1); // 1 МГц
+  LL_TIM_SetAutoReload(KBD_TIM, 1000 - 1);
+  LL_TIM_GenerateEvent_UPDATE(KBD_TIM);
+  LL_TIM_ClearFlag_UPDATE(KBD_TIM);
+  LL_TIM_EnableIT_UPDATE(KBD_TIM);
+
+  LL_EXTI_SetEXTISource(LL_EXTI_CONFIG_PORTB, LL_EXTI_CONFIG_LINE10);
+  LL_EXTI_SetEXTISource(LL_EXTI_CONFIG_PORTB, LL_EXTI_CONFIG_LINE12);
+  LL_EXTI_SetEXTISource(LL_EXTI_CONFIG_PORTB, LL_EXTI_CONFIG_LINE13);
+  LL_EXTI_SetEXTISource(LL_EXTI_CONFIG_PORTB, LL_EXTI_CONFIG_LINE14);
+  LL_EXTI_SetEXTISource(LL_EXTI_CONFIG_PORTB, LL_EXTI_CONFIG_LINE15);
+  LL_EXTI_EnableFallingTrig(EXTI_LINES);
+
+  NVIC_SetPriority(KBD_TIM_IRQn, KBD_IRQ_PRIORITY);
+  NVIC_EnableIRQ(KBD_TIM_IRQn);
+  NVIC_SetPriority(EXTI4_15_IRQn, KBD_IRQ_PRIORITY);
+  NVIC_EnableIRQ(EXTI4_15_IRQn);
+}
+
+void EXTI4_15_IRQHandler(void) {
+  LL_EXTI_ClearFlag(EXTI_LINES);
+  kbd_wake();
+}
+
+void TIM7_IRQHandler(void) {
+  LL_TIM_ClearFlag_UPDATE(KBD_TIM);
+  keyboard_tick();
+  if (all_idle()) {
+    kbd_sleep();
+  }
+}
+
 // ============================================================================
 // Публичный API
 // ============================================================================
@@ -211,6 +328,27 @@ void keyboard_init(key_event_callback_t callback) {
     g_keys[i].counter = 0;
     g_keys[i].physical_state = false;
   }
+  g_queue_head = g_queue_tail = 0;
+
+  // Первый скан синхронно: keyboard_is_pressed годится сразу после init
+  keyboard_tick();
+
+  hw_init();
+  if (all_idle()) {
+    kbd_sleep();
+  } else {
+    kbd_wake();
+  }
+}
+
+void keyboard_poll(void) {
+  while (g_queue_tail != g_queue_head) {
+    key_queue_item_t item = g_queue[g_queue_tail];
+    g_queue_tail = (g_queue_tail + 1) & (KEYBOARD_QUEUE_SIZE - 1);
+    if (g_callback) {
+      g_callback((KEY_Code_t)item.key, (KEY_State_t)item.event);
+    }
+  }
 }
 
 key_timing_config_t keyboard_get_default_timing(void) {
@@ -227,26 +365,6 @@ void keyboard_set_timing(const key_timing_config_t *config) {
   g_timing = *config;
 }
 
-void keyboard_tick_1ms(void) {
-  // Сканировать матрицу
-  KEY_Code_t matrix_key = scan_matrix();
-
-  // Обработать все клавиши матрицы
-  for (uint8_t col = 0; col < 5; col++) {
-    for (uint8_t row = 0; row < 4; row++) {
-      KEY_Code_t key = g_keymap[col][row];
-      if (key != KEY_NONE) {
-        bool is_pressed = (key == matrix_key);
-        process_key_fsm(key, is_pressed);
-      }
-    }
-  }
-
-  // Обработать PTT отдельно
-  bool ptt_pressed = scan_ptt();
-  process_key_fsm(KEY_PTT, ptt_pressed);
-}
-
 bool keyboard_is_pressed(KEY_Code_t key) {
   if (key >= KEY_COUNT) {
     return false;
@@ -53,6 +53,9 @@ typedef struct {
   bool repeat_enabled; // Включить автоповтор
 } key_timing_config_t;
 
+// Размер очереди событий (степень двойки)
+#define KEYBOARD_QUEUE_SIZE 16
+
 // Callback для обработки событий
 typedef void (*key_event_callback_t)(KEY_Code_t key, KEY_State_t event);
 
@@ -65,8 +68,9 @@ void keyboard_set_timing(const key_timing_config_t *config);
 // Получить конфигурацию по умолчанию
 key_timing_config_t keyboard_get_default_timing(void);
 
-// Вызывать каждые 1ms из таймера
-void keyboard_tick_1ms(void);
+// Отдать накопленные события в callback. Вызывать из главного цикла:
+// сканирование и FSM работают в прерываниях (EXTI строк + таймер 1 мс)
+void keyboard_poll(void);
 
 // Получить текущее состояние кнопки (нажата/не нажата)
 bool keyboard_is_pressed(KEY_Code_t key);
@@ -24,6 +24,15 @@ static uint32_t SectorCacheAddr = 0x1000000;
 static uint8_t SectorCache[SECTOR_SIZE];
 static uint8_t BlackHole[1];
 static volatile bool TC_Flag;
+static volatile bool ReadPending;
+
+#define BATCH_NONE 0xFFFFFFFF
+static uint32_t BatchBlock = BATCH_NONE; // собираемый блок назначения
+static uint16_t BatchPages;              // измененные страницы, уже в scratch
+static int8_t BatchPage = -1;            // страница, открытая в SectorCache
+static bool BatchPageChanged;
+static bool BatchActive;
+static uint32_t BatchUsbEnabled;
 
 static inline void CS_Assert() { GPIO_ResetOutputPin(CS_PIN); }
 
@@ -77,7 +86,7 @@ static void SPI_Init() {
   LL_SPI_Enable(SPIx);
 }
 
-static void SPI_ReadBuf(uint8_t *Buf, uint32_t Size) {
+static void SPI_StartRead(uint8_t *Buf, uint32_t Size) {
   LL_SPI_Disable(SPIx);
   LL_DMA_DisableChannel(DMA1, CHANNEL_RD);
   LL_DMA_DisableChannel(DMA1, CHANNEL_WR);
@@ -120,7 +129,10 @@ static void SPI_ReadBuf(uint8_t *Buf, uint32_t Size) {
   LL_SPI_EnableDMAReq_RX(SPIx);
   LL_SPI_Enable(SPIx);
   LL_SPI_EnableDMAReq_TX(SPIx);
+}
 
+static void SPI_ReadBuf(uint8_t *Buf, uint32_t Size) {
+  SPI_StartRead(Buf, Size);
   while (!TC_Flag)
     ;
 }
@@ -187,9 +199,25 @@ static uint8_t ReadStatusReg(uint32_t Which);
 static void WaitWIP();
 static void WriteEnable();
 static void SectorErase(uint32_t Addr);
+static void PageErase(uint32_t Addr);
 static void SectorProgram(uint32_t Addr, const uint8_t *Buf, uint32_t Size);
 static void PageProgram(uint32_t Addr, const uint8_t *Buf, uint32_t Size);
 
+// MSC работает с флешем из прерывания USB: транзакции основного цикла
+// идут с замаскированным USB, чтобы не разорвать обмен под CS
+static uint32_t Lock() {
+  uint32_t Enabled = NVIC_GetEnableIRQ(USB_IRQn);
+  NVIC_DisableIRQ(USB_IRQn);
+  PY25Q16_ReadWait();
+  return Enabled;
+}
+
+static void Unlock(uint32_t Enabled) {
+  if (Enabled) {
+    NVIC_EnableIRQ(USB_IRQn);
+  }
+}
+
 void PY25Q16_Init() {
   CS_Release();
   SPI_Init();
@@ -199,6 +227,7 @@ void PY25Q16_ReadBuffer(uint32_t Address, void *pBuffer, uint32_t Size) {
   /* #ifdef DEBUG
       printf("spi flash read: %06x %ld\n", Address, Size);
   #endif */
+  uint32_t Enabled = Lock();
   CS_Assert();
 
   SPI_WriteByte(0x03); // Fast read
@@ -213,6 +242,25 @@ void PY25Q16_ReadBuffer(uint32_t Address, void *pBuffer, uint32_t Size) {
   }
 
   CS_Release();
+  Unlock(Enabled);
+}
+
+void PY25Q16_ReadAsync(uint32_t Address, void *pBuffer, uint32_t Size) {
+  uint32_t Enabled = Lock();
+  CS_Assert();
+
+  SPI_WriteByte(0x03);
+  WriteAddr(Address);
+
+  // CS отпустит прерывание DMA по окончании
+  ReadPending = true;
+  SPI_StartRead((uint8_t *)pBuffer, Size);
+  Unlock(Enabled);
+}
+
+void PY25Q16_ReadWait() {
+  while (ReadPending)
+    ;
 }
 
 void PY25Q16_WriteBuffer(uint32_t Address, const void *pBuffer, uint32_t Size,
@@ -224,6 +272,7 @@ void PY25Q16_WriteBuffer(uint32_t Address, const void *pBuffer, uint32_t Size,
   uint32_t SecAddr = SecIndex * SECTOR_SIZE;
   uint32_t SecOffset = Address % SECTOR_SIZE;
   uint32_t SecSize = SECTOR_SIZE - SecOffset;
+  uint32_t Enabled = Lock();
 
   while (Size) {
     if (Size < SecSize) {
@@ -235,19 +284,29 @@ void PY25Q16_WriteBuffer(uint32_t Address, const void *pBuffer, uint32_t Size,
       SectorCacheAddr = SecAddr;
     }
 
-    if (0 != memcmp(pBuffer, (char *)SectorCache + SecOffset, SecSize)) {
-      bool Erase = false;
-      for (uint32_t i = 0; i < SecSize; i++) {
-        if (0xff != SectorCache[SecOffset + i]) {
-          Erase = true;
-          break;
+    // Сравнение со страницей: пишется только участок от первого до
+    // последнего измененного байта, стирание — если нужен переход 0->1
+    const uint8_t *Src = pBuffer;
+    int16_t First = -1;
+    int16_t Last = -1;
+    bool Erase = false;
+    for (uint32_t i = 0; i < SecSize; i++) {
+      uint8_t Old = SectorCache[SecOffset + i];
+      if (Old != Src[i]) {
+        if (First < 0) {
+          First = i;
         }
+        Last = i;
+        Erase |= (Old & Src[i]) != Src[i];
       }
+    }
 
-      memcpy(SectorCache + SecOffset, pBuffer, SecSize);
+    if (First >= 0) {
+      memcpy(SectorCache + SecOffset + First, Src + First, Last - First + 1);
 
       if (Erase) {
-        SectorErase(SecAddr);
+        // Стирается только эта страница, соседние в 4 КБ блоке не трогаем
+        PageErase(SecAddr);
         if (Append) {
           SectorProgram(SecAddr, SectorCache, SecOffset + SecSize);
           memset(SectorCache + SecOffset + SecSize, 0xff,
@@ -256,7 +315,7 @@ void PY25Q16_WriteBuffer(uint32_t Address, const void *pBuffer, uint32_t Size,
           SectorProgram(SecAddr, SectorCache, SECTOR_SIZE);
         }
       } else {
-        SectorProgram(Address, pBuffer, SecSize);
+        SectorProgram(Address + First, Src + First, Last - First + 1);
       }
     }
 
@@ -268,14 +327,147 @@ void PY25Q16_WriteBuffer(uint32_t Address, const void *pBuffer, uint32_t Size,
     SecOffset = 0;
     SecSize = SECTOR_SIZE;
   } // while
+
+  Unlock(Enabled);
 }
 
 void PY25Q16_SectorErase(uint32_t Address) {
-  Address -= (Address % SECTOR_SIZE);
+  // 0x20 стирает 4 КБ, кеш может лежать в любой его части
+  Address -= (Address % PY25Q16_ERASE_SIZE);
+  uint32_t Enabled = Lock();
   SectorErase(Address);
-  if (SectorCacheAddr == Address) {
+  if (SectorCacheAddr >= Address &&
+      SectorCacheAddr < Address + PY25Q16_ERASE_SIZE) {
     memset(SectorCache, 0xff, SECTOR_SIZE);
   }
+  Unlock(Enabled);
+}
+
+void PY25Q16_Program(uint32_t Address, const void *pBuffer, uint32_t Size) {
+  uint32_t Enabled = Lock();
+  if (SectorCacheAddr + SECTOR_SIZE > Address &&
+      SectorCacheAddr < Address + Size) {
+    SectorCacheAddr = 0x1000000;
+  }
+  SectorProgram(Address, pBuffer, Size);
+  Unlock(Enabled);
+}
+
+static bool IsErased(const uint8_t *Buf, uint32_t Size) {
+  for (uint32_t i = 0; i < Size; i++) {
+    if (Buf[i] != 0xff) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void BatchClosePage() {
+  if (BatchPage < 0) {
+    return;
+  }
+  if (BatchPageChanged) {
+    // Служебный блок стирается лениво: до первой реально измененной страницы
+    if (!BatchPages) {
+      SectorErase(PY25Q16_SCRATCH_ADDR);
+    }
+    if (!IsErased(SectorCache, SECTOR_SIZE)) {
+      SectorProgram(PY25Q16_SCRATCH_ADDR + BatchPage * SECTOR_SIZE,
+                    SectorCache, SECTOR_SIZE);
+    }
+    BatchPages |= 1 << BatchPage;
+  }
+  BatchPage = -1;
+}
+
+static void BatchFlush() {
+  if (BatchBlock == BATCH_NONE) {
+    return;
+  }
+  BatchClosePage();
+
+  if (BatchPages) {
+    // Недостающие страницы — из исходного блока, затем одно стирание
+    for (uint8_t p = 0; p < PY25Q16_ERASE_SIZE / SECTOR_SIZE; p++) {
+      if (!(BatchPages & (1 << p))) {
+        PY25Q16_ReadBuffer(BatchBlock + p * SECTOR_SIZE, SectorCache,
+                           SECTOR_SIZE);
+        if (!IsErased(SectorCache, SECTOR_SIZE)) {
+          SectorProgram(PY25Q16_SCRATCH_ADDR + p * SECTOR_SIZE, SectorCache,
+                        SECTOR_SIZE);
+        }
+      }
+    }
+    SectorErase(BatchBlock);
+    for (uint8_t p = 0; p < PY25Q16_ERASE_SIZE / SECTOR_SIZE; p++) {
+      PY25Q16_ReadBuffer(PY25Q16_SCRATCH_ADDR + p * SECTOR_SIZE, SectorCache,
+                         SECTOR_SIZE);
+      if (!IsErased(SectorCache, SECTOR_SIZE)) {
+        SectorProgram(BatchBlock + p * SECTOR_SIZE, SectorCache, SECTOR_SIZE);
+      }
+    }
+  }
+
+  BatchBlock = BATCH_NONE;
+  BatchPages = 0;
+}
+
+void PY25Q16_BatchWrite(uint32_t Address, const void *pBuffer, uint32_t Size) {
+  const uint8_t *Src = pBuffer;
+
+  if (!BatchActive) {
+    BatchUsbEnabled = Lock();
+    BatchActive = true;
+    // SectorCache занят под открытую страницу пакета
+    SectorCacheAddr = 0x1000000;
+  }
+
+  while (Size) {
+    uint32_t Block = Address - Address % PY25Q16_ERASE_SIZE;
+    int8_t Page = (Address % PY25Q16_ERASE_SIZE) / SECTOR_SIZE;
+    uint32_t Offset = Address % SECTOR_SIZE;
+    uint32_t n = SECTOR_SIZE - Offset;
+    if (n > Size) {
+      n = Size;
+    }
+
+    if (Block != BatchBlock) {
+      BatchFlush();
+      BatchBlock = Block;
+    }
+
+    if (Page != BatchPage) {
+      BatchClosePage();
+      // Возврат к уже собранной странице: блок сбрасывается и собирается
+      // заново
+      if (BatchPages & (1 << Page)) {
+        BatchFlush();
+        BatchBlock = Block;
+      }
+      PY25Q16_ReadBuffer(Block + Page * SECTOR_SIZE, SectorCache, SECTOR_SIZE);
+      BatchPage = Page;
+      BatchPageChanged = false;
+    }
+
+    if (memcmp(SectorCache + Offset, Src, n)) {
+      memcpy(SectorCache + Offset, Src, n);
+      BatchPageChanged = true;
+    }
+
+    Address += n;
+    Src += n;
+    Size -= n;
+  }
+}
+
+void PY25Q16_BatchEnd() {
+  if (!BatchActive) {
+    return;
+  }
+  BatchFlush();
+  SectorCacheAddr = 0x1000000;
+  BatchActive = false;
+  Unlock(BatchUsbEnabled);
 }
 
 static inline void WriteAddr(uint32_t Addr) {
@@ -341,6 +533,21 @@ static void SectorErase(uint32_t Addr) {
   WaitWIP();
 }
 
+static void PageErase(uint32_t Addr) {
+#ifdef DEBUG
+  printf("spi flash page erase: %06x\n", Addr);
+#endif
+  WriteEnable();
+  WaitWIP();
+
+  CS_Assert();
+  SPI_WriteByte(0x81);
+  WriteAddr(Addr);
+  CS_Release();
+
+  WaitWIP();
+}
+
 static void SectorProgram(uint32_t Addr, const uint8_t *Buf, uint32_t Size) {
   uint32_t Size1 = PAGE_SIZE - (Addr % PAGE_SIZE);
 
@@ -402,5 +609,10 @@ void DMA1_Channel4_5_6_7_IRQHandler() {
     LL_SPI_DisableDMAReq_RX(SPIx);
 
     TC_Flag = true;
+
+    if (ReadPending) {
+      CS_Release();
+      ReadPending = false;
+    }
   }
 }
@@ -4,11 +4,30 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#define PY25Q16_PAGE_SIZE 256
+#define PY25Q16_ERASE_SIZE 4096
+#define PY25Q16_SIZE (2 * 1024 * 1024)
+// Последний erase-блок — служебный, через него пересобираются блоки
+#define PY25Q16_SCRATCH_ADDR (PY25Q16_SIZE - PY25Q16_ERASE_SIZE)
+
 void PY25Q16_Init();
 void PY25Q16_ReadBuffer(uint32_t Address, void *pBuffer, uint32_t Size);
+// Чтение через DMA без ожидания (Size >= 16); любая следующая операция
+// с флешем сначала дождется его окончания
+void PY25Q16_ReadAsync(uint32_t Address, void *pBuffer, uint32_t Size);
+void PY25Q16_ReadWait();
 void PY25Q16_WriteBuffer(uint32_t Address, const void *pBuffer, uint32_t Size,
                          bool Append);
 void PY25Q16_SectorErase(uint32_t Address);
+// Программирование по уже стертой области, без чтения/стирания сектора
+void PY25Q16_Program(uint32_t Address, const void *pBuffer, uint32_t Size);
+
+// Пакетная запись: изменения собираются в служебном блоке, каждый 4 КБ
+// блок назначения стирается не больше одного раза (и не стирается, если
+// данные не изменились). Служебный блок должен быть свободен (FAT_Flush);
+// от BatchWrite до BatchEnd прерывание USB замаскировано.
+void PY25Q16_BatchWrite(uint32_t Address, const void *pBuffer, uint32_t Size);
+void PY25Q16_BatchEnd();
 
 static uint8_t PY25Q16_ReadStatus(void);
 static void PY25Q16_WaitBusy(void);
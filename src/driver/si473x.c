@@ -16,6 +16,7 @@ static const uint8_t SI47XX_I2C_ADDR = 0x22;
 #define RST_LOW
 
 RSQStatus rsqStatus;
+static uint8_t siStatus; // байт статуса последнего ответа (CTS, RDSINT...)
 static SsbMode currentSsbMode;
 
 SI47XX_MODE si4732mode = SI47XX_FM;
@@ -29,10 +30,12 @@ bool SI47XX_ReadBuffer(uint8_t *buf, uint8_t size) {
   while (retries--) {
     I2C_Start();
     if (I2C_Write(SI47XX_I2C_ADDR + 1) == 0) {
-      if (I2C_ReadBuffer(buf, size) == 0) {
-        I2C_Stop();
-        return true;
-      }
+      // I2C_ReadBuffer возвращает число байт: раньше каждое чтение
+      // считалось ошибкой и повторялось 5 раз
+      I2C_ReadBuffer(buf, size);
+      I2C_Stop();
+      siStatus = buf[0];
+      return true;
     }
     I2C_Stop();
     SYSTICK_DelayUs(1); // Short retry delay
@@ -59,12 +62,21 @@ bool SI47XX_IsSSB() {
   return si4732mode == SI47XX_USB || si4732mode == SI47XX_LSB;
 }
 
-void waitToSend() {
+// Ожидание CTS: чтение статуса само занимает десятки мкс, отдельная пауза
+// не нужна. Если чип не отвечает (выключен, завис) — выходим по таймауту
+// вместо вечного цикла
+#define SI47XX_CTS_TIMEOUT_MS 300
+
+bool waitToSend() {
   uint8_t tmp = 0;
-  do {
-    SYSTICK_DelayUs(1);
-    SI47XX_ReadBuffer((uint8_t *)&tmp, 1);
-  } while (!(tmp & STATUS_CTS));
+  uint32_t start = Now();
+  while (!SI47XX_ReadBuffer(&tmp, 1) || !(tmp & STATUS_CTS)) {
+    if (Now() - start > SI47XX_CTS_TIMEOUT_MS) {
+      Log("[SI] CTS timeout");
+      return false;
+    }
+  }
+  return true;
 }
 
 #include "../ui/graphics.h" // X_X
@@ -84,7 +96,9 @@ void SI47XX_downloadPatch() {
     EEPROM_ReadBuffer(PATCH_START + offset, buf, eepromN);
 
     for (uint16_t i = 0; i < eepromN; i += 8) {
-      waitToSend();
+      if (!waitToSend()) {
+        return;
+      }
       SI47XX_WriteBuffer(buf + i, 8);
     }
   }
@@ -361,11 +375,24 @@ void SI47XX_SetBandwidth(SI47XX_FilterBW AMCHFLT, bool AMPLFLT) {
   SI47XX_SetProperty(PROP_AM_CHANNEL_FILTER, (cfg.raw[1] << 8) | cfg.raw[0]);
 }
 
-void SI47XX_ReadRDS(uint8_t buf[13]) {
+// Ответ FM_RDS_STATUS: pop — забрать группу из FIFO, иначе только статус
+// и число групп в FIFO (buf[3])
+bool SI47XX_ReadRDS(uint8_t buf[13], bool pop) {
   uint8_t cmd[2] = {CMD_FM_RDS_STATUS, RDS_STATUS_ARG1_CLEAR_INT};
-  waitToSend();
-  SI47XX_WriteBuffer(cmd, 2);
-  SI47XX_ReadBuffer(buf, 13);
+  if (!pop) {
+    cmd[1] |= RDS_STATUS_ARG1_STATUS_ONLY;
+  }
+  return waitToSend() && SI47XX_WriteBuffer(cmd, 2) &&
+         SI47XX_ReadBuffer(buf, 13);
+}
+
+// Статус из последнего обмена; refresh — дочитать один байт статуса
+uint8_t SI47XX_GetStatus(bool refresh) {
+  if (refresh) {
+    uint8_t tmp;
+    SI47XX_ReadBuffer(&tmp, 1);
+  }
+  return siStatus;
 }
 
 void SI47XX_SetSeekFmLimits(uint32_t bottom, uint32_t top) {
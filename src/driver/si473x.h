@@ -571,7 +571,8 @@ void SI47XX_PowerUp();
 void SI47XX_PatchPowerUp();
 void SI47XX_PowerDown();
 void SI47XX_SetFreq(uint16_t freq);
-void SI47XX_ReadRDS(uint8_t buf[13]);
+bool SI47XX_ReadRDS(uint8_t buf[13], bool pop);
+uint8_t SI47XX_GetStatus(bool refresh);
 void SI47XX_SwitchMode(SI47XX_MODE mode);
 bool SI47XX_IsSSB();
 void RSQ_GET();
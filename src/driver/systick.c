@@ -4,8 +4,13 @@
 static uint32_t gTickMultiplier;
 static volatile uint32_t gGlobalSysTickCounter;
 
+// Профилирование сна: такты в WFI за текущее окно
+static uint32_t gIdleCycles;
+static uint32_t gIdleWindowStart;
+static uint8_t gIdlePercent;
+
 void SYSTICK_Init(void) {
-  SysTick_Config(48000);
+  SysTick_Config(SYSTICK_CYCLES_PER_MS);
   gTickMultiplier = 48;
 
   NVIC_SetPriority(SysTick_IRQn, 0);
@@ -35,6 +40,16 @@ void SysTick_Handler(void) { gGlobalSysTickCounter++; }
 
 uint32_t Now() { return gGlobalSysTickCounter; }
 
+uint32_t SYSTICK_Cycles(void) {
+  uint32_t ms, val;
+  // Перечитываем, если тик сменился между чтениями
+  do {
+    ms = gGlobalSysTickCounter;
+    val = SysTick->VAL;
+  } while (ms != gGlobalSysTickCounter);
+  return ms * SYSTICK_CYCLES_PER_MS + (SysTick->LOAD - val);
+}
+
 void SYSTICK_DelayMs(uint32_t ms) { SYSTICK_DelayUs(ms * 1000); }
 
 void SetTimeout(uint32_t *v, uint32_t t) {
@@ -42,3 +57,33 @@ void SetTimeout(uint32_t *v, uint32_t t) {
 }
 
 bool CheckTimeout(uint32_t *v) { return Now() >= *v; }
+
+void SYSTICK_Sleep(void) {
+  __disable_irq();
+  // SysTick уже ждёт обработки — спать нечего, счёт сна был бы неверным
+  if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) {
+    __enable_irq();
+    return;
+  }
+  uint32_t from = SysTick->VAL;
+  // С запрещёнными прерываниями WFI выходит по ожидающему прерыванию,
+  // обработчик выполняется после __enable_irq()
+  __WFI();
+  uint32_t to = SysTick->VAL;
+  bool wrapped = SCB->ICSR & SCB_ICSR_PENDSTSET_Msk;
+  __enable_irq();
+
+  gIdleCycles += wrapped ? from + SysTick->LOAD + 1 - to : from - to;
+}
+
+void SYSTICK_UpdateIdleStats(void) {
+  uint32_t elapsed = Now() - gIdleWindowStart;
+  if (!elapsed) {
+    return;
+  }
+  gIdlePercent = gIdleCycles / (elapsed * gTickMultiplier * 10);
+  gIdleCycles = 0;
+  gIdleWindowStart = Now();
+}
+
+uint8_t SYSTICK_GetIdlePercent(void) { return gIdlePercent; }
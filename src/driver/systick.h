@@ -4,10 +4,22 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+// Тактов ядра (и SysTick) за 1 мс
+#define SYSTICK_CYCLES_PER_MS 48000
+
 void SYSTICK_Init(void);
 void SYSTICK_DelayUs(uint32_t Delay);
 void SYSTICK_DelayMs(uint32_t Delay);
 uint32_t Now();
+// Монотонный счетчик тактов (переполняется за ~89 с, годится для разностей)
+uint32_t SYSTICK_Cycles(void);
+
+// Сон до ближайшего прерывания (не дольше тика 1 мс) с учётом времени сна
+void SYSTICK_Sleep(void);
+// Закрыть окно статистики сна (раз в секунду из главного цикла)
+void SYSTICK_UpdateIdleStats(void);
+// Доля времени во сне за последнее окно, %
+uint8_t SYSTICK_GetIdlePercent(void);
 
 void SetTimeout(uint32_t *v, uint32_t t);
 bool CheckTimeout(uint32_t *v);
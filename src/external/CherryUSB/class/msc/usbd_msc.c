@@ -47,6 +47,11 @@ USB_NOCACHE_RAM_SECTION struct usbd_msc_cfg_priv {
     uint32_t scsi_blk_nbr;
 
     uint8_t block_buffer[CONFIG_USBDEV_MSC_BLOCK_SIZE];
+#ifdef CONFIG_USBDEV_MSC_DOUBLE_BUFFER
+    /* second read buffer: filled by the storage while the first one is sent */
+    uint8_t block_buffer2[CONFIG_USBDEV_MSC_BLOCK_SIZE];
+    uint8_t *prefetch_buffer;
+#endif
 } usbd_msc_cfg;
 
 #ifdef CONFIG_USBDEV_MSC_THREAD
@@ -323,6 +328,7 @@ static bool SCSI_startStopUnit(uint8_t **data, uint32_t *len)
     } else if ((usbd_msc_cfg.cbw.CB[4] & 0x3U) == 0x2U) /* START=0 and LOEJ Load Eject=1 */
     {
         //SCSI_MEDIUM_EJECTED;
+        usbd_msc_sync_cache(usbd_msc_cfg.cbw.bLUN);
     } else if ((usbd_msc_cfg.cbw.CB[4] & 0x3U) == 0x3U) /* START=1 and LOEJ Load Eject=1 */
     {
         //SCSI_MEDIUM_UNLOCKED;
@@ -334,6 +340,24 @@ static bool SCSI_startStopUnit(uint8_t **data, uint32_t *len)
     return true;
 }
 
+__WEAK void usbd_msc_sync_cache(uint8_t lun)
+{
+}
+
+static bool SCSI_synchronizeCache(uint8_t **data, uint32_t *len)
+{
+    if (usbd_msc_cfg.cbw.dDataLength != 0U) {
+        SCSI_SetSenseData(SCSI_KCQIR_INVALIDCOMMAND);
+        return false;
+    }
+
+    usbd_msc_sync_cache(usbd_msc_cfg.cbw.bLUN);
+
+    *data = NULL;
+    *len = 0;
+    return true;
+}
+
 static bool SCSI_preventAllowMediaRemoval(uint8_t **data, uint32_t *len)
 {
     if (usbd_msc_cfg.cbw.dDataLength != 0U) {
@@ -493,6 +517,9 @@ static bool SCSI_read10(uint8_t **data, uint32_t *len)
         return false;
     }
     usbd_msc_cfg.stage = MSC_DATA_IN;
+#ifdef CONFIG_USBDEV_MSC_DOUBLE_BUFFER
+    usbd_msc_cfg.prefetch_buffer = NULL;
+#endif
     return SCSI_processRead();
 }
 
@@ -520,6 +547,9 @@ static bool SCSI_read12(uint8_t **data, uint32_t *len)
         return false;
     }
     usbd_msc_cfg.stage = MSC_DATA_IN;
+#ifdef CONFIG_USBDEV_MSC_DOUBLE_BUFFER
+    usbd_msc_cfg.prefetch_buffer = NULL;
+#endif
     return SCSI_processRead();
 }
 
@@ -627,9 +657,22 @@ static bool SCSI_verify10(uint8_t **data, uint32_t *len)
 }
 #endif
 
+#ifdef CONFIG_USBDEV_MSC_DOUBLE_BUFFER
+__WEAK int usbd_msc_sector_read_start(uint32_t sector, uint8_t *buffer, uint32_t length)
+{
+    return usbd_msc_sector_read(sector, buffer, length);
+}
+
+__WEAK int usbd_msc_sector_read_wait(void)
+{
+    return 0;
+}
+#endif
+
 static bool SCSI_processRead(void)
 {
     uint32_t transfer_len;
+    uint8_t *buffer = usbd_msc_cfg.block_buffer;
 
     USB_LOG_DBG("read lba:%d\r\n", usbd_msc_cfg.start_sector);
 
@@ -641,12 +684,23 @@ static bool SCSI_processRead(void)
     usb_osal_sem_give(msc_sem);
     return true;
 #else
-    if (usbd_msc_sector_read(usbd_msc_cfg.start_sector, usbd_msc_cfg.block_buffer, transfer_len) != 0) {
+#ifdef CONFIG_USBDEV_MSC_DOUBLE_BUFFER
+    if (usbd_msc_cfg.prefetch_buffer) {
+        /* this chunk was requested while the previous one was being sent */
+        buffer = usbd_msc_cfg.prefetch_buffer;
+        usbd_msc_cfg.prefetch_buffer = NULL;
+        if (usbd_msc_sector_read_wait() != 0) {
+            SCSI_SetSenseData(SCSI_KCQHE_UREINRESERVEDAREA);
+            return false;
+        }
+    } else
+#endif
+    if (usbd_msc_sector_read(usbd_msc_cfg.start_sector, buffer, transfer_len) != 0) {
         SCSI_SetSenseData(SCSI_KCQHE_UREINRESERVEDAREA);
         return false;
     }
 #endif
-    usbd_ep_start_write(mass_ep_data[MSD_IN_EP_IDX].ep_addr, usbd_msc_cfg.block_buffer, transfer_len);
+    usbd_ep_start_write(mass_ep_data[MSD_IN_EP_IDX].ep_addr, buffer, transfer_len);
 
     usbd_msc_cfg.start_sector += (transfer_len / usbd_msc_cfg.scsi_blk_size);
     usbd_msc_cfg.nsectors -= (transfer_len / usbd_msc_cfg.scsi_blk_size);
@@ -655,6 +709,16 @@ static bool SCSI_processRead(void)
     if (usbd_msc_cfg.nsectors == 0) {
         usbd_msc_cfg.stage = MSC_SEND_CSW;
     }
+#if defined(CONFIG_USBDEV_MSC_DOUBLE_BUFFER) && !defined(CONFIG_USBDEV_MSC_THREAD)
+    else {
+        /* ping-pong: fetch the next chunk into the buffer that is not on the wire */
+        uint8_t *next = (buffer == usbd_msc_cfg.block_buffer) ? usbd_msc_cfg.block_buffer2 : usbd_msc_cfg.block_buffer;
+        transfer_len = MIN(usbd_msc_cfg.nsectors * usbd_msc_cfg.scsi_blk_size, CONFIG_USBDEV_MSC_BLOCK_SIZE);
+        if (usbd_msc_sector_read_start(usbd_msc_cfg.start_sector, next, transfer_len) == 0) {
+            usbd_msc_cfg.prefetch_buffer = next;
+        }
+    }
+#endif
 
     return true;
 }
@@ -798,6 +862,10 @@ static bool SCSI_CBWDecode(uint32_t nbytes)
             case SCSI_CMD_WRITE12:
                 ret = SCSI_write12(NULL, 0);
                 break;
+            case SCSI_CMD_SYNCHCACHE10:
+            case SCSI_CMD_SYNCHCACHE16:
+                ret = SCSI_synchronizeCache(&buf2send, &len2send);
+                break;
             case SCSI_CMD_VERIFY10:
                 //ret = SCSI_verify10(NULL, 0);
                 ret = false;
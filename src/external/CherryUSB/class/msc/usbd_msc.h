@@ -20,6 +20,13 @@ struct usbd_interface *usbd_msc_init_intf(struct usbd_interface *intf,
 void usbd_msc_get_cap(uint8_t lun, uint32_t *block_num, uint16_t *block_size);
 int usbd_msc_sector_read(uint32_t sector, uint8_t *buffer, uint32_t length);
 int usbd_msc_sector_write(uint32_t sector, uint8_t *buffer, uint32_t length);
+/* Double-buffered read (CONFIG_USBDEV_MSC_DOUBLE_BUFFER): start filling the
+ * buffer and return, completion is awaited before the buffer is sent.
+ * Weak defaults fall back to usbd_msc_sector_read */
+int usbd_msc_sector_read_start(uint32_t sector, uint8_t *buffer, uint32_t length);
+int usbd_msc_sector_read_wait(void);
+/* SYNCHRONIZE CACHE / eject: flush write-back cache, weak no-op by default */
+void usbd_msc_sync_cache(uint8_t lun);
 
 void usbd_msc_set_readonly(bool readonly);
 
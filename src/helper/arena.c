@@ -0,0 +1,40 @@
+#include "arena.h"
+#include "../driver/uart.h"
+#include <string.h>
+
+static uint32_t pool[ARENA_SIZE / 4];
+static uint16_t top;
+static uint16_t peak;
+static bool failed;
+
+void *ARENA_Alloc(size_t size) {
+  size = (size + 3) & ~3u;
+  if (size > (size_t)(ARENA_SIZE - top)) {
+    LogC(LOG_C_RED, "[ARENA] No room for %u (used %u)", size, top);
+    failed = true;
+    return NULL;
+  }
+  void *p = (uint8_t *)pool + top;
+  memset(p, 0, size);
+  top += size;
+  if (top > peak) {
+    peak = top;
+  }
+  return p;
+}
+
+uint16_t ARENA_Mark(void) { return top; }
+
+void ARENA_Release(uint16_t mark) {
+  if (mark < top) {
+    top = mark;
+  }
+}
+
+uint16_t ARENA_Peak(void) { return peak; }
+
+bool ARENA_Failed(void) {
+  bool f = failed;
+  failed = false;
+  return f;
+}
@@ -0,0 +1,28 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Общий пул для буферов приложений. Выделение — сдвигом вершины,
+// освобождение — откатом к отметке. APPS_run/APPS_exit откатывают пул
+// к отметке приложения на своем уровне стека приложений, поэтому
+// приложение берет память в init и не освобождает ее само.
+// Размер — самая глубокая цепочка из меню с запасом: CHSCAN > LOOTLIST >
+// CHLIST > CH_CFG > TEXTINPUT = 40 + 12 + 16 = 68 B, сброс (RESET) поверх
+// еще 16 B. Через список приложений цепочка может быть любой, поэтому
+// нехватка пула — штатная ситуация: APPS_init не открывает приложение.
+#define ARENA_SIZE 96
+
+// Обнуленный блок, выровненный на 4. Выделять только из init приложения
+// (один раз за вход); при нехватке пула — NULL, init должен выйти сразу
+void *ARENA_Alloc(size_t size);
+// Было ли отказано в выделении с прошлого вызова
+bool ARENA_Failed(void);
+uint16_t ARENA_Mark(void);
+void ARENA_Release(uint16_t mark);
+// Максимальная занятость пула с запуска
+uint16_t ARENA_Peak(void);
+
+#endif /* end of include guard: ARENA_H */
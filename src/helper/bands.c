@@ -4,6 +4,7 @@
 #include "../radio.h"
 #include "channels.h"
 #include "measurements.h"
+#include "vfs.h"
 #include <stdint.h>
 
 // NOTE
@@ -35,8 +36,16 @@ Band defaultBand = {
 };
 
 static DBand allBands[BANDS_COUNT_MAX];
-static int16_t allBandIndex; // -1 if default is current
+static int16_t allBandIndex = -1; // -1 if default is current
 static uint8_t allBandsSize = 0;
+static DBand defaultInfo;
+
+// Индекс интервалов: отрезок k = [segStart[k], segStart[k + 1]) принадлежит
+// диапазону segBand[k] (-1 — вне диапазонов). Вложенность разрешена при
+// построении: на отрезке берется самый узкий диапазон
+static uint32_t segStart[BANDS_COUNT_MAX * 2];
+static int8_t segBand[BANDS_COUNT_MAX * 2];
+static uint8_t segCount;
 
 static uint8_t scanlistBandIndex;
 
@@ -70,27 +79,101 @@ PCal POWER_CALIBRATIONS[] = {
     {.s = 470 * MHZ, .e = 620 * MHZ, .c = {46, 77, 140}},
 };
 
-static int16_t bandIndexByFreq(uint32_t f, bool preciseStep) {
-  int16_t newBandIndex = -1;
-  uint32_t smallestDiff = UINT32_MAX;
+static void fillBand(DBand *b, uint16_t mr, const CH *ch) {
+  *b = (DBand){
+      .mr = mr,
+      .s = ch->rxF,
+      .e = ch->txF,
+      .powCalib = ch->misc.powCalib,
+      .squelch = ch->squelch,
+      .step = ch->step,
+      .modulation = ch->modulation,
+      .bw = ch->bw,
+      .radio = ch->radio,
+      .power = ch->power,
+      .gainIndex = ch->gainIndex,
+  };
+}
+
+static void addPoint(uint32_t p) {
+  uint8_t i = segCount;
+  while (i && segStart[i - 1] > p) {
+    segStart[i] = segStart[i - 1];
+    i--;
+  }
+  if (i && segStart[i - 1] == p) {
+    // уже есть — сдвинутое возвращаем на место
+    for (; i < segCount; ++i) {
+      segStart[i] = segStart[i + 1];
+    }
+    return;
+  }
+  segStart[i] = p;
+  segCount++;
+}
+
+// Самый узкий диапазон, содержащий f; при равной ширине — первый
+static int8_t narrowestAt(uint32_t f) {
+  int8_t best = -1;
   for (uint8_t i = 0; i < allBandsSize; ++i) {
-    DBand *b = &allBands[i];
-    if (f < b->s || f > b->e) {
-      continue;
+    const DBand *b = &allBands[i];
+    if (f >= b->s && f <= b->e &&
+        (best < 0 || b->e - b->s < allBands[best].e - allBands[best].s)) {
+      best = i;
     }
-    if (preciseStep & (f % StepFrequencyTable[b->step])) {
+  }
+  return best;
+}
+
+static void buildIndex(void) {
+  segCount = 0;
+  for (uint8_t i = 0; i < allBandsSize; ++i) {
+    addPoint(allBands[i].s);
+    addPoint(allBands[i].e + 1);
+  }
+
+  // Соседние отрезки с одним диапазоном склеиваем
+  uint8_t n = 0;
+  for (uint8_t k = 0; k < segCount; ++k) {
+    int8_t band = narrowestAt(segStart[k]);
+    if (n && segBand[n - 1] == band) {
       continue;
     }
-    uint32_t diff = DeltaF(b->s, f) + DeltaF(b->e, f);
-    if (diff < smallestDiff) {
-      smallestDiff = diff;
-      newBandIndex = i;
+    segStart[n] = segStart[k];
+    segBand[n] = band;
+    n++;
+  }
+  segCount = n;
+}
+
+static int16_t bandIndexByFreq(uint32_t f) {
+  // Последний отрезок с началом <= f
+  uint8_t lo = 0;
+  uint8_t hi = segCount;
+  while (lo < hi) {
+    uint8_t mid = (lo + hi) / 2;
+    if (segStart[mid] <= f) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
     }
   }
-  return newBandIndex;
+  return lo ? segBand[lo - 1] : -1;
+}
+
+static int16_t bandIndexByMr(int16_t mr) {
+  for (uint8_t i = 0; i < allBandsSize; ++i) {
+    if (allBands[i].mr == mr) {
+      return i;
+    }
+  }
+  return -1;
 }
 
 void BANDS_Load(void) {
+  const int16_t currentMr = allBandIndex >= 0 ? allBands[allBandIndex].mr : -1;
+
+  allBandsSize = 0;
   for (int16_t chNum = 0; chNum < CHANNELS_GetCountMax() - 2; ++chNum) {
     if (CHANNELS_GetMeta(chNum).type != TYPE_BAND) {
       continue;
@@ -98,12 +181,7 @@ void BANDS_Load(void) {
 
     CH ch;
     CHANNELS_Load(chNum, &ch);
-    allBands[allBandsSize] = (DBand){
-        .mr = chNum,
-        .s = ch.rxF,
-        .e = ch.txF,
-        .step = ch.step,
-    };
+    fillBand(&allBands[allBandsSize], chNum, &ch);
 
     allBandsSize++;
 
@@ -111,8 +189,37 @@ void BANDS_Load(void) {
       break;
     }
   }
+
+  fillBand(&defaultInfo, 0, &defaultBand);
+  buildIndex();
+  allBandIndex = bandIndexByMr(currentMr);
+}
+
+void BANDS_OnChannelSaved(int16_t num, const CH *p) {
+  const int16_t i = bandIndexByMr(num);
+  const bool isBand = p->meta.type == TYPE_BAND;
+  if (i < 0 && !isBand) {
+    return;
+  }
+  VFS_BandsChanged();
+  if (i >= 0 && isBand) {
+    fillBand(&allBands[i], num, p);
+    buildIndex();
+    return;
+  }
+  // Диапазон появился или удален: порядок и индексы меняются
+  BANDS_Load();
 }
 
+const DBand *BANDS_InfoByFrequency(uint32_t f) {
+  int16_t index = bandIndexByFreq(f);
+  return index >= 0 ? &allBands[index] : &defaultInfo;
+}
+
+uint8_t BANDS_GetCount() { return allBandsSize; }
+
+uint16_t BANDS_GetMR(uint8_t i) { return allBands[i].mr; }
+
 bool BANDS_InRange(const uint32_t f, const Band p) {
   return f >= p.rxF && f <= p.txF;
 }
@@ -132,13 +239,11 @@ void BANDS_SetRadioParamsFromCurrentBand() {
 void BANDS_Select(int16_t num, bool copyToVfo) {
   CHANNELS_Load(num, &gCurrentBand);
   Log("Select Band %s", gCurrentBand.name);
-  for (int16_t i = 0; i < gScanlistSize; ++i) {
-    if (gScanlist[i] == num) {
-      scanlistBandIndex = i;
-      allBandIndex = bandIndexByFreq(gCurrentBand.rxF, true);
-      // Log("SL band index %u", i);
-      break;
-    }
+  int16_t i = CHANNELS_ScanlistIndexOf(num);
+  if (i >= 0) {
+    scanlistBandIndex = i;
+    allBandIndex = bandIndexByMr(num);
+    // Log("SL band index %u", i);
   }
   if (!BANDS_InRange(ctx->frequency, gCurrentBand)) {
     // Log("[BAND] !in range");
@@ -164,7 +269,7 @@ void BANDS_SelectScan(int8_t i) {
 }
 
 Band BANDS_ByFrequency(uint32_t f) {
-  int16_t index = bandIndexByFreq(f, false);
+  int16_t index = bandIndexByFreq(f);
   if (index >= 0) {
     Band b;
     CHANNELS_Load(allBands[index].mr, &b);
@@ -179,7 +284,7 @@ uint8_t BANDS_GetScanlistIndex() { return scanlistBandIndex; }
  * Select band, return if changed
  */
 bool BANDS_SelectByFrequency(uint32_t f, bool copyToVfo) {
-  int16_t newBandIndex = bandIndexByFreq(f, false);
+  int16_t newBandIndex = bandIndexByFreq(f);
   if (allBandIndex != newBandIndex ||
       gCurrentBand.meta.type == TYPE_BAND_DETACHED) {
     allBandIndex = newBandIndex;
@@ -199,7 +304,7 @@ bool BANDS_SelectBandRelativeByScanlist(bool next) {
   }
   uint8_t oldScanlistBandIndex = scanlistBandIndex;
   scanlistBandIndex = IncDecU(scanlistBandIndex, 0, gScanlistSize, next);
-  BANDS_Select(gScanlist[scanlistBandIndex], true);
+  BANDS_Select(CHANNELS_ScanlistAt(scanlistBandIndex), true);
   return oldScanlistBandIndex != scanlistBandIndex;
 }
 
@@ -211,11 +316,11 @@ void BANDS_SaveCurrent(void) {
 }
 
 PowerCalibration BANDS_GetPowerCalib(uint32_t f) {
-  Band b = BANDS_ByFrequency(f);
+  const DBand *b = BANDS_InfoByFrequency(f);
 
-  // not TYPE_BAND_DETACHED
-  if (b.meta.type == TYPE_BAND && b.misc.powCalib.e > 0) {
-    return b.misc.powCalib;
+  // у defaultBand калибровки нет
+  if (b->powCalib.e > 0) {
+    return b->powCalib;
   }
 
   for (uint8_t ci = 0; ci < ARRAY_SIZE(POWER_CALIBRATIONS); ++ci) {
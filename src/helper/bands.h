@@ -12,11 +12,19 @@ typedef struct {
   uint32_t e;
 } SBand;
 
+// Горячие поля диапазона в RAM: поиск по частоте не читает флеш
 typedef struct {
   uint32_t s;
   uint32_t e;
   uint16_t mr;
-  Step step; // needed to select band by freq
+  PowerCalibration powCalib;
+  Squelch squelch;
+  Step step : 4;
+  ModulationType modulation : 4;
+  BK4819_FilterBandwidth_t bw : 4;
+  Radio radio : 2;
+  TXOutputPower power : 2;
+  uint8_t gainIndex : 5;
 } DBand;
 
 typedef struct {
@@ -26,11 +34,18 @@ typedef struct {
 } PCal;
 
 void BANDS_Load();
+uint8_t BANDS_GetCount();
+uint16_t BANDS_GetMR(uint8_t i);
 
 PowerCalibration BANDS_GetPowerCalib(uint32_t f);
+// Самый узкий диапазон, содержащий f (или параметры defaultBand)
+const DBand *BANDS_InfoByFrequency(uint32_t f);
+// Обновить кэш после записи ячейки num (вызывается из CHANNELS_Save)
+void BANDS_OnChannelSaved(int16_t num, const CH *p);
 
 bool BANDS_SelectBandRelativeByScanlist(bool next);
 void BANDS_SelectScan(int8_t i);
+// Полная запись диапазона с флеша
 Band BANDS_ByFrequency(uint32_t f);
 bool BANDS_SelectByFrequency(uint32_t f, bool copyToVfo);
 void BANDS_SaveCurrent();
@@ -3,6 +3,7 @@
 #include "../driver/systick.h"
 #include "../driver/uart.h"
 #include "../external/printf/printf.h"
+#include "../helper/bands.h"
 #include "../helper/lootlist.h"
 #include "../helper/measurements.h"
 #include "../radio.h"
@@ -11,13 +12,23 @@
 #include <string.h>
 
 uint16_t gScanlistSize = 0;
-uint16_t gScanlist[SCANLIST_MAX] = {0};
+
+// Скан-лист — битовое множество номеров каналов; slRank[w] — число
+// отмеченных каналов в словах до w, для перехода от позиции к номеру
+#define SL_WORDS (SCANLIST_MAX / 32)
+static uint32_t slBits[SL_WORDS];
+static uint16_t slRank[SL_WORDS];
 CHType gScanlistType = TYPE_CH;
 const char *CH_TYPE_NAMES[6] = {"EMPTY", "CH", "BAND", "VFO", "FLD", "SND"};
 const char *TX_POWER_NAMES[4] = {"ULow", "Low", "Mid", "High"};
 const char *TX_OFFSET_NAMES[4] = {"None", "+", "-", "Freq"};
 const char *TX_CODE_TYPES[4] = {"None", "CT", "DCS", "-DCS"};
 
+static CHRow rows[CH_ROWS_CACHE_SIZE] = {
+    [0 ... CH_ROWS_CACHE_SIZE - 1] = {.num = -1},
+};
+static uint8_t rowsNext; // слот под следующий промах, по кругу
+
 static uint32_t getChannelsEnd() {
   uint32_t eepromSize = SETTINGS_GetEEPROMSize();
   uint32_t minSizeWithPatch = CHANNELS_OFFSET + CH_SIZE + PATCH_SIZE;
@@ -49,9 +60,67 @@ void CHANNELS_Save(int16_t num, CH *p) {
     Log(">> W CH%u OFS=%u '%s': f=%u, radio=%u", num, GetChannelOffset(num),
         p->name, p->rxF, p->radio);
     EEPROM_WriteBuffer(GetChannelOffset(num), p, CH_SIZE);
+    for (uint8_t i = 0; i < CH_ROWS_CACHE_SIZE; ++i) {
+      if (rows[i].num == num) {
+        rows[i].num = -1;
+      }
+    }
+    BANDS_OnChannelSaved(num, p);
+  }
+}
+
+// Для импорта: записи копятся и ложатся на флеш в CHANNELS_CommitBatch
+void CHANNELS_SaveBatch(int16_t num, CH *p) {
+  if (num >= 0) {
+    EEPROM_WriteBatch(GetChannelOffset(num), p, CH_SIZE);
+  }
+}
+
+void CHANNELS_CommitBatch() {
+  EEPROM_CommitBatch();
+  CHANNELS_InvalidateRows();
+}
+
+void CHANNELS_InvalidateRows(void) {
+  for (uint8_t i = 0; i < CH_ROWS_CACHE_SIZE; ++i) {
+    rows[i].num = -1;
   }
 }
 
+const CHRow *CHANNELS_GetRow(int16_t num) {
+  for (uint8_t i = 0; i < CH_ROWS_CACHE_SIZE; ++i) {
+    if (rows[i].num == num) {
+      return &rows[i];
+    }
+  }
+
+  // Окно меню сдвигается на строку, старейший слот вытесняется
+  CHRow *row = &rows[rowsNext];
+  rowsNext = (rowsNext + 1) % CH_ROWS_CACHE_SIZE;
+
+  CH ch;
+  CHANNELS_Load(num, &ch);
+
+  row->num = num;
+  row->meta = ch.meta;
+  row->allowTx = ch.allowTx;
+  row->scanlists = ch.scanlists;
+  row->freq[0] = '\0';
+  if (ch.meta.type) {
+    memcpy(row->name, ch.name, sizeof(ch.name));
+    row->name[sizeof(ch.name)] = '\0';
+  } else {
+    snprintf(row->name, sizeof(row->name), "CH-%u", num);
+  }
+  // Запись с флеша может быть битой (0xFFFFFFFF): строка обрезается по
+  // размеру поля, а не уходит в соседнюю строку кэша
+  if (CHANNELS_IsFreqable(ch.meta.type)) {
+    snprintf(row->freq, sizeof(row->freq), "%u.%03u %u.%03u", ch.rxF / MHZ,
+             ch.rxF / 100 % 1000, ch.txF / MHZ, ch.txF / 100 % 1000);
+  }
+  return row;
+}
+
 void CHANNELS_Delete(int16_t num) {
   CH _ch;
   memset(&_ch, 0, sizeof(_ch));
@@ -72,9 +141,52 @@ uint16_t CHANNELS_Scanlists(int16_t num) {
 }
 static int16_t chScanlistIndex = 0;
 
+static void buildRanks(void) {
+  uint16_t n = 0;
+  for (uint8_t w = 0; w < SL_WORDS; ++w) {
+    slRank[w] = n;
+    n += __builtin_popcount(slBits[w]);
+  }
+  gScanlistSize = n;
+}
+
+uint16_t CHANNELS_ScanlistAt(uint16_t index) {
+  if (index >= gScanlistSize) {
+    return 0;
+  }
+  // Последнее слово, где до него отмечено не больше index каналов
+  uint8_t lo = 0;
+  uint8_t hi = SL_WORDS;
+  while (hi - lo > 1) {
+    uint8_t mid = (lo + hi) / 2;
+    if (slRank[mid] <= index) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  uint32_t bits = slBits[lo];
+  for (uint16_t skip = index - slRank[lo]; skip; --skip) {
+    bits &= bits - 1; // снять младший бит
+  }
+  return lo * 32 + __builtin_ctz(bits);
+}
+
+int16_t CHANNELS_ScanlistIndexOf(uint16_t num) {
+  if (num >= SCANLIST_MAX) {
+    return -1;
+  }
+  const uint32_t bit = 1UL << (num % 32);
+  const uint32_t word = slBits[num / 32];
+  if (!(word & bit)) {
+    return -1;
+  }
+  return slRank[num / 32] + __builtin_popcount(word & (bit - 1));
+}
+
 int16_t CHANNELS_GetCurrentScanlistCH() {
   if (gScanlistSize) {
-    return gScanlist[chScanlistIndex];
+    return CHANNELS_ScanlistAt(chScanlistIndex);
   }
   return -1;
 }
@@ -96,11 +208,9 @@ void CHANNELS_Next(bool next) {
 
 void CHANNELS_SetScanlistIndexFromRadio() {
   if (vfo->mode == MODE_CHANNEL && gScanlistSize) {
-    for (uint16_t i = 0; i < gScanlistSize; ++i) {
-      if (gScanlist[i] == vfo->channel_index) {
-        chScanlistIndex = i;
-        break;
-      }
+    int16_t i = CHANNELS_ScanlistIndexOf(vfo->channel_index);
+    if (i >= 0) {
+      chScanlistIndex = i;
     }
   }
 }
@@ -117,9 +227,9 @@ void CHANNELS_LoadScanlist(CHTypeFilter typeFilter, uint16_t scanlistMask) {
   Log("Load SL w type_filter=%u", typeFilter);
   if (gSettings.currentScanlist != scanlistMask) {
     gSettings.currentScanlist = scanlistMask;
-    SETTINGS_Save();
+    SETTINGS_DelayedSave();
   }
-  gScanlistSize = 0;
+  memset(slBits, 0, sizeof(slBits));
   for (uint16_t i = 0; i < CHANNELS_GetCountMax(); ++i) {
     CHMeta meta = CHANNELS_GetMeta(i);
     bool isSaveFilter = typeFilter == TYPE_FILTER_BAND_SAVE ||
@@ -136,11 +246,11 @@ void CHANNELS_LoadScanlist(CHTypeFilter typeFilter, uint16_t scanlistMask) {
                          (CHANNELS_Scanlists(i) & scanlistMask) ||
                          isEmptyChannelToSave;
     if (isOurScanlist) {
-      gScanlist[gScanlistSize] = i;
-      gScanlistSize++;
+      slBits[i / 32] |= 1UL << (i % 32);
       // Log("Load CH %u in SL", i);
     }
   }
+  buildRanks();
   if (typeFilter == TYPE_FILTER_CH || typeFilter == TYPE_FILTER_CH_SAVE) {
     chScanlistIndex = 0;
     CHANNELS_SetScanlistIndexFromRadio();
@@ -148,6 +258,13 @@ void CHANNELS_LoadScanlist(CHTypeFilter typeFilter, uint16_t scanlistMask) {
   Log("SL sz: %u", gScanlistSize);
 }
 
+// Записи поменялись в обход меню — перечитать текущий скан-лист
+void CHANNELS_ReloadScanlist() {
+  CHTypeFilter typeFilter = _typeFilter;
+  _typeFilter = 0;
+  CHANNELS_LoadScanlist(typeFilter, _scanlistMask);
+}
+
 void CHANNELS_LoadBlacklistToLoot() {
   const uint16_t SCANLIST_MASK = 1 << 15;
   for (int16_t i = 0; i < CHANNELS_GetCountMax(); ++i) {
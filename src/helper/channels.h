@@ -158,14 +158,37 @@ typedef MR Band;
 typedef MR VFO;
 typedef MR CH;
 
+// Кэш строк списка каналов: окно меню + запас на прокрутку назад
+#define CH_ROWS_CACHE_SIZE 8
+
+// Разобранная запись для отрисовки строки списка, строки готовы заранее
+typedef struct {
+  int16_t num; // -1 — слот пуст
+  CHMeta meta;
+  bool allowTx;
+  uint16_t scanlists;
+  char name[11];  // имя или "CH-n"
+  char freq[18];  // "rx.fff tx.fff", пусто для нечастотных типов
+} CHRow;
+
 uint16_t CHANNELS_GetCountMax();
 
 void CHANNELS_Load(int16_t num, CH *p);
 void CHANNELS_Save(int16_t num, CH *p);
+void CHANNELS_SaveBatch(int16_t num, CH *p);
+void CHANNELS_CommitBatch();
+void CHANNELS_ReloadScanlist();
 bool CHANNELS_LoadBuf();
 int16_t CHANNELS_GetCurrentScanlistCH();
+// Номер канала на позиции index загруженного скан-листа
+uint16_t CHANNELS_ScanlistAt(uint16_t index);
+// Позиция канала в скан-листе или -1
+int16_t CHANNELS_ScanlistIndexOf(uint16_t num);
 void CHANNELS_Next(bool next);
 void CHANNELS_Delete(int16_t i);
+// Строка списка из кэша; при промахе читается с флеша один раз
+const CHRow *CHANNELS_GetRow(int16_t num);
+void CHANNELS_InvalidateRows(void);
 bool CHANNELS_Existing(int16_t i);
 uint16_t CHANNELS_Scanlists(int16_t i);
 void CHANNELS_LoadScanlist(CHTypeFilter type, uint16_t n);
@@ -186,7 +209,6 @@ uint16_t CHANNELS_ScanlistByKey(uint16_t sl, KEY_Code_t key, bool longPress);
 void CHANNELS_SelectScanlistByKey(KEY_Code_t key, bool longPress);
 
 extern uint16_t gScanlistSize;
-extern uint16_t gScanlist[SCANLIST_MAX];
 extern const char *TX_POWER_NAMES[4];
 extern const char *TX_OFFSET_NAMES[4];
 extern const char *TX_CODE_TYPES[4];
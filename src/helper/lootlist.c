@@ -9,6 +9,8 @@
 
 static Loot loot[LOOT_SIZE_MAX] = {0};
 static uint32_t lastTimeCheck = 0;
+static uint32_t toneCheckAt = 0;
+static uint32_t toneF = 0; // частота, к которой относятся toneCheckAt и флаги
 static int16_t lootIndex = -1;
 
 Loot *gLastActiveLoot = NULL;
@@ -148,6 +150,61 @@ void LOOT_Replace(Measurement *item, uint32_t f) {
   lastTimeCheck = Now();
 }
 
+static bool readTone(Loot *item) {
+  uint32_t cd = 0;
+  uint16_t ct = 0;
+  uint8_t Code = 0xFF;
+  switch (BK4819_GetCxCSSScanResult(&cd, &ct)) {
+  case BK4819_CSS_RESULT_CDCSS:
+    Code = DCS_GetCdcssCode(cd);
+    if (Code != 0xFF) {
+      item->cd = Code;
+    }
+    break;
+  case BK4819_CSS_RESULT_CTCSS:
+    Code = DCS_GetCtcssCode(ct);
+    if (Code != 0xFF) {
+      item->ct = Code;
+    }
+    break;
+  default:
+    break;
+  }
+  return Code != 0xFF;
+}
+
+// Тон читается на фронте открытия и повторно, пока не определится; дальше
+// до конца передачи смотрим только флаги прерываний BK4829.
+// Таймер и флаги привязаны к измеряемой частоте: при смене частоты
+// (сканирование) флаги REG_02 защелкнуты на другой и сбрасываются
+static void updateTone(Loot *item) {
+  bool edge = !item->open;
+  if (item->f != toneF) {
+    toneF = item->f;
+    BK4819_ReadInterrupts();
+    edge = true;
+  }
+  if (edge) {
+    item->toneKnown = false;
+    toneCheckAt = Now();
+  }
+  if ((int32_t)(Now() - toneCheckAt) < 0) {
+    return;
+  }
+  toneCheckAt = Now() + LOOT_TONE_CHECK_MS;
+
+  if (!item->toneKnown) {
+    item->toneKnown = readTone(item);
+    return;
+  }
+
+  const uint16_t lost = BK4819_REG_02_CTCSS_LOST | BK4819_REG_02_CDCSS_LOST |
+                        BK4819_REG_02_CxCSS_TAIL;
+  if (BK4819_ReadInterrupts() & lost) {
+    item->toneKnown = false;
+  }
+}
+
 void LOOT_UpdateEx(Loot *item, Measurement *msm) {
   if (item == NULL) {
     return;
@@ -165,26 +222,7 @@ void LOOT_UpdateEx(Loot *item, Measurement *msm) {
     gLastActiveLootIndex = LOOT_IndexOf(item);
   }
   if (msm->open) {
-    uint32_t cd = 0;
-    uint16_t ct = 0;
-    uint8_t Code = 0;
-    BK4819_CssScanResult_t res = BK4819_GetCxCSSScanResult(&cd, &ct);
-    switch (res) {
-    case BK4819_CSS_RESULT_CDCSS:
-      Code = DCS_GetCdcssCode(cd);
-      if (Code != 0xFF) {
-        item->cd = Code;
-      }
-      break;
-    case BK4819_CSS_RESULT_CTCSS:
-      Code = DCS_GetCtcssCode(ct);
-      if (Code != 0xFF) {
-        item->ct = Code;
-      }
-      break;
-    default:
-      break;
-    }
+    updateTone(item);
     item->lastTimeOpen = Now();
   }
   lastTimeCheck = Now();
@@ -219,7 +257,7 @@ void LOOT_RemoveBlacklisted(void) {
 
 CH LOOT_ToCh(const Loot *loot) {
   // TODO: automatic params by simple "band plan"
-  Band p = BANDS_ByFrequency(loot->f);
+  const DBand *p = BANDS_InfoByFrequency(loot->f);
   CH ch = {
       .meta.type = TYPE_CH,
       .rxF = loot->f,
@@ -231,12 +269,12 @@ CH LOOT_ToCh(const Loot *loot) {
               .rx.value = 0,
               .tx.value = 0,
           },
-      .radio = p.radio,
-      .modulation = p.modulation,
-      .power = p.power,
-      .bw = p.bw,
-      .squelch = p.squelch,
-      .gainIndex = p.gainIndex,
+      .radio = p->radio,
+      .modulation = p->modulation,
+      .power = p->power,
+      .bw = p->bw,
+      .squelch = p->squelch,
+      .gainIndex = p->gainIndex,
   };
 
   mhzToS(ch.name, ch.rxF);
@@ -7,6 +7,8 @@
 #include <stdint.h>
 
 #define LOOT_SIZE_MAX 200
+// Как часто при открытом шумоподавителе читать тон/флаги прерываний BK4829
+#define LOOT_TONE_CHECK_MS 200
 
 typedef struct {
   uint32_t f;
@@ -18,6 +20,7 @@ typedef struct {
   bool open : 1;
   bool blacklist : 1;
   bool whitelist : 1;
+  bool toneKnown : 1; // ct/cd определены для текущей передачи
 } Loot;
 
 typedef struct {
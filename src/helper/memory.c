@@ -0,0 +1,20 @@
+#include "memory.h"
+
+// Символы из firmware.ld
+extern uint32_t _sdata[];
+extern uint32_t _ebss[];
+extern uint32_t _estack[];
+
+MemStats MEM_GetStats(void) {
+  // Стек растет вниз: первое испорченное слово снизу — его пик
+  const uint32_t *p = _ebss;
+  while (p < _estack && *p == MEM_STACK_PAINT) {
+    p++;
+  }
+
+  return (MemStats){
+      .statics = (uint32_t)_ebss - (uint32_t)_sdata,
+      .stackPeak = (uint32_t)_estack - (uint32_t)p,
+      .freeMin = (uint32_t)p - (uint32_t)_ebss,
+  };
+}
@@ -0,0 +1,18 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <stdint.h>
+
+// Свободная RAM между .bss и стеком заливается этим словом в start.s
+// до вызова main; граница залитого — максимальная глубина стека
+#define MEM_STACK_PAINT 0xA5A5A5A5
+
+typedef struct {
+  uint32_t statics;   // .data + .bss
+  uint32_t stackPeak; // максимум использованного стека с запуска
+  uint32_t freeMin;   // минимум свободного между .bss и стеком
+} MemStats;
+
+MemStats MEM_GetStats(void);
+
+#endif /* end of include guard: MEMORY_H */
@@ -0,0 +1,214 @@
+#include "rds.h"
+#include "../driver/si473x.h"
+#include "../driver/st7565.h"
+#include "../driver/systick.h"
+#include <string.h>
+
+// Блок принимается при исправленных ошибках не более 1-2 бит
+#define RDS_BLE_MAX 1
+
+#define PS_SEGMENTS 4
+#define RT_SEGMENTS 16
+
+RDSInfo gRDS;
+
+static char psWork[8];
+static uint8_t psMask;
+
+static char rtWork[64];
+static uint16_t rtMask;
+static int8_t rtEnd = -1; // сегмент с концом текста (0x0D), -1 — не встречен
+static bool rtAB;
+
+static uint32_t lastPoll;
+static bool backlog; // в FIFO остались группы сверх RDS_GROUPS_PER_UPDATE
+
+static uint8_t bleOf(uint8_t ble, uint8_t block) {
+  return (ble >> (6 - block * 2)) & 3;
+}
+
+static char rdsChar(uint8_t c) { return (c < ' ' || c > '~') ? ' ' : c; }
+
+void RDS_Reset(void) {
+  memset(&gRDS, 0, sizeof(gRDS));
+  memset(psWork, ' ', sizeof(psWork));
+  memset(rtWork, ' ', sizeof(rtWork));
+  psMask = 0;
+  rtMask = 0;
+  rtEnd = -1;
+  backlog = false;
+  gRedrawScreen = true;
+}
+
+static void publishPS(void) {
+  if (memcmp(gRDS.ps, psWork, sizeof(psWork))) {
+    memcpy(gRDS.ps, psWork, sizeof(psWork));
+    gRDS.ps[8] = '\0';
+    gRedrawScreen = true;
+  }
+  psMask = 0;
+}
+
+static void publishRT(uint8_t len) {
+  // Хвостовые пробелы не показываем
+  while (len && rtWork[len - 1] == ' ') {
+    len--;
+  }
+  if (strncmp(gRDS.rt, rtWork, len) || gRDS.rt[len]) {
+    memcpy(gRDS.rt, rtWork, len);
+    gRDS.rt[len] = '\0';
+    gRedrawScreen = true;
+  }
+  rtMask = 0;
+  rtEnd = -1;
+}
+
+// 0A/0B: 2 символа PS в блоке D
+static void decodePS(const uint16_t *b, uint8_t ble) {
+  if (bleOf(ble, 3) > RDS_BLE_MAX) {
+    return;
+  }
+  uint8_t seg = b[1] & 3;
+  psWork[seg * 2] = rdsChar(b[3] >> 8);
+  psWork[seg * 2 + 1] = rdsChar(b[3] & 0xFF);
+  psMask |= 1 << seg;
+  gRDS.ta = (b[1] >> 4) & 1;
+
+  if (psMask == (1 << PS_SEGMENTS) - 1) {
+    publishPS();
+  }
+}
+
+// 2A: 4 символа в C и D, 2B: 2 символа в D
+static void decodeRT(const uint16_t *b, uint8_t ble, bool versionB) {
+  bool ab = (b[1] >> 4) & 1;
+  if (ab != rtAB) {
+    // Смена флага A/B — новый текст, накопленное сбрасываем
+    rtAB = ab;
+    rtMask = 0;
+    rtEnd = -1;
+    memset(rtWork, ' ', sizeof(rtWork));
+  }
+
+  uint8_t seg = b[1] & 0x0F;
+  uint8_t width = versionB ? 2 : 4;
+  char chars[4];
+  if (versionB) {
+    if (bleOf(ble, 3) > RDS_BLE_MAX) {
+      return;
+    }
+    chars[0] = b[3] >> 8;
+    chars[1] = b[3] & 0xFF;
+  } else {
+    if (bleOf(ble, 2) > RDS_BLE_MAX || bleOf(ble, 3) > RDS_BLE_MAX) {
+      return;
+    }
+    chars[0] = b[2] >> 8;
+    chars[1] = b[2] & 0xFF;
+    chars[2] = b[3] >> 8;
+    chars[3] = b[3] & 0xFF;
+  }
+
+  for (uint8_t i = 0; i < width; ++i) {
+    if (chars[i] == '\r') {
+      rtEnd = seg;
+      memset(rtWork + seg * width + i, ' ', sizeof(rtWork) - seg * width - i);
+      break;
+    }
+    rtWork[seg * width + i] = rdsChar(chars[i]);
+  }
+  rtMask |= 1 << seg;
+
+  // Текст готов, когда приняты все сегменты до конца (или все 16)
+  uint8_t last = rtEnd >= 0 ? rtEnd : RT_SEGMENTS - 1;
+  uint16_t need = (uint16_t)((1UL << (last + 1)) - 1);
+  if ((rtMask & need) == need) {
+    publishRT((last + 1) * width);
+  }
+}
+
+// 4A: MJD, UTC и смещение в получасах
+static void decodeCT(const uint16_t *b, uint8_t ble) {
+  if (bleOf(ble, 2) > RDS_BLE_MAX || bleOf(ble, 3) > RDS_BLE_MAX) {
+    return;
+  }
+  int16_t minutes = (((b[2] & 1) << 4) | (b[3] >> 12)) * 60 + ((b[3] >> 6) & 0x3F);
+  int16_t offset = (b[3] & 0x1F) * 30;
+  minutes += (b[3] & 0x20) ? -offset : offset;
+  minutes = (minutes + 24 * 60) % (24 * 60);
+
+  gRDS.hour = minutes / 60;
+  gRDS.minute = minutes % 60;
+  gRDS.ctValid = true;
+  gRedrawScreen = true;
+}
+
+void RDS_DecodeGroup(const uint16_t blocks[4], uint8_t ble) {
+  // Без верного блока B тип группы неизвестен
+  if (bleOf(ble, 1) > RDS_BLE_MAX) {
+    return;
+  }
+  if (bleOf(ble, 0) <= RDS_BLE_MAX) {
+    gRDS.pi = blocks[0];
+  }
+
+  uint8_t type = blocks[1] >> 12;
+  bool versionB = (blocks[1] >> 11) & 1;
+  gRDS.tp = (blocks[1] >> 10) & 1;
+  gRDS.pty = (blocks[1] >> 5) & 0x1F;
+
+  switch (type) {
+  case 0:
+    decodePS(blocks, ble);
+    break;
+  case 2:
+    decodeRT(blocks, ble, versionB);
+    break;
+  case 4:
+    if (!versionB) {
+      decodeCT(blocks, ble);
+    }
+    break;
+  }
+}
+
+void RDS_Update(void) {
+  if (!isSi4732On || si4732mode != SI47XX_FM) {
+    return;
+  }
+
+  // RDSINT приходит в байте статуса любого ответа; сам опрашиваем редко
+  if (!backlog && !(SI47XX_GetStatus(false) & STATUS_RDSINT)) {
+    if (Now() - lastPoll < RDS_POLL_MS) {
+      return;
+    }
+    lastPoll = Now();
+    if (!(SI47XX_GetStatus(true) & STATUS_RDSINT)) {
+      return;
+    }
+  }
+
+  uint8_t buf[13];
+  if (!SI47XX_ReadRDS(buf, false)) {
+    return;
+  }
+  uint8_t used = buf[3];
+  backlog = used > RDS_GROUPS_PER_UPDATE;
+  if (backlog) {
+    used = RDS_GROUPS_PER_UPDATE;
+  }
+
+  for (uint8_t i = 0; i < used; ++i) {
+    if (!SI47XX_ReadRDS(buf, true)) {
+      return;
+    }
+    if (!(buf[2] & FIELD_RDS_STATUS_RESP2_SYNC)) {
+      continue;
+    }
+    uint16_t blocks[4];
+    for (uint8_t k = 0; k < 4; ++k) {
+      blocks[k] = (buf[4 + k * 2] << 8) | buf[5 + k * 2];
+    }
+    RDS_DecodeGroup(blocks, buf[12]);
+  }
+}
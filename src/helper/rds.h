@@ -0,0 +1,33 @@
+#ifndef RDS_H
+#define RDS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Опрос статуса SI4732, когда RDSINT не пришел в ответе на другие команды
+#define RDS_POLL_MS 100
+// Групп из FIFO за один вызов RDS_Update: ограничивает трафик I2C
+#define RDS_GROUPS_PER_UPDATE 4
+
+// Опубликованные данные RDS: текст обновляется только целым сегментом
+// (все части PS/RT приняты), до этого копится в рабочих буферах
+typedef struct {
+  uint16_t pi;
+  uint8_t pty;
+  bool tp;
+  bool ta;
+  bool ctValid;
+  uint8_t hour;   // местное время из группы 4A
+  uint8_t minute;
+  char ps[9];
+  char rt[65];
+} RDSInfo;
+
+void RDS_Reset(void);
+void RDS_Update(void);
+// Разбор группы: блоки A..D и байт ошибок блоков (BLE, по 2 бита на блок)
+void RDS_DecodeGroup(const uint16_t blocks[4], uint8_t ble);
+
+extern RDSInfo gRDS;
+
+#endif /* end of include guard: RDS_H */
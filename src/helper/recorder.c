@@ -0,0 +1,132 @@
+#include "recorder.h"
+#include "../driver/fat_fs.h"
+#include "../driver/systick.h"
+#include "../driver/uart.h"
+#include "../external/printf/printf.h"
+#include "../ui/spectrum.h"
+#include <string.h>
+
+// Как часто сбрасывать FAT и размер файла на флеш. Каждый сброс
+// перезаписывает erase-блок каталога, поэтому редко: при пропадании питания
+// теряется не больше интервала
+#define REC_SYNC_INTERVAL_MS 600000
+
+static FAT_File file;
+static bool active;
+static uint32_t lastSync;
+
+static uint8_t chunk[32];
+static uint8_t chunkLen;
+static bool chunkOk;
+
+static void flush(void) {
+  if (chunkLen && !FAT_Append(&file, chunk, chunkLen)) {
+    chunkOk = false;
+  }
+  chunkLen = 0;
+}
+
+static void put(const void *data, uint8_t size) {
+  if (chunkLen + size > sizeof(chunk)) {
+    flush();
+  }
+  memcpy(chunk + chunkLen, data, size);
+  chunkLen += size;
+}
+
+static void putU8(uint8_t v) { put(&v, 1); }
+
+bool REC_Start(void) {
+  if (active) {
+    return true;
+  }
+
+  if (!FAT_IsReady()) {
+    FAT_Init();
+  }
+
+  // Номер после наибольшего существующего SWEEPnnn.BIN — один проход
+  // каталога вместо проверки каждого имени
+  int16_t last = -1;
+  fat_dir_entry_t e;
+  for (uint16_t i = 0; FAT_ReadDir(&i, &e);) {
+    if (memcmp(e.name, "SWEEP", 5) || memcmp(e.name + 8, "BIN", 3)) {
+      continue;
+    }
+    int16_t n = 0;
+    for (uint8_t k = 5; k < 8 && n >= 0; ++k) {
+      char c = e.name[k];
+      n = (c >= '0' && c <= '9') ? n * 10 + (c - '0') : -1;
+    }
+    if (n > last) {
+      last = n;
+    }
+  }
+
+  char name[12];
+  sprintf(name, "SWEEP%03uBIN", last + 1);
+
+  if (last >= 999 || !FAT_Open(&file, name, true)) {
+    LogC(LOG_C_RED, "[REC] No space");
+    return false;
+  }
+
+  active = FAT_Append(&file, "SWP1", 4);
+  lastSync = Now();
+  LogC(LOG_C_BRIGHT_GREEN, "[REC] Start %s", name);
+  return active;
+}
+
+void REC_Stop(void) {
+  if (!active) {
+    return;
+  }
+  active = false;
+  FAT_Close(&file);
+  Log("[REC] Stop, %u bytes", file.entry.file_size);
+}
+
+bool REC_IsActive(void) { return active; }
+
+void REC_AddSweep(const Band *b) {
+  if (!active) {
+    return;
+  }
+
+  uint8_t count;
+  const uint16_t *rssi = SP_GetHistory(&count);
+  if (!count) {
+    return;
+  }
+
+  uint32_t head[3] = {Now(), b->rxF, b->txF};
+  chunkLen = 0;
+  chunkOk = true;
+
+  putU8(REC_FRAME_SYNC);
+  put(head, sizeof(head));
+  putU8(count);
+  put(&rssi[0], sizeof(uint16_t));
+
+  for (uint8_t i = 1; i < count; ++i) {
+    int32_t d = rssi[i] - rssi[i - 1];
+    if (d > -128 && d < 128) {
+      putU8(d);
+    } else {
+      putU8(REC_DELTA_ESCAPE);
+      put(&rssi[i], sizeof(uint16_t));
+    }
+  }
+  flush();
+
+  if (!chunkOk) {
+    LogC(LOG_C_YELLOW, "[REC] Volume full or changed by host");
+    REC_Stop();
+    return;
+  }
+
+  if (Now() - lastSync >= REC_SYNC_INTERVAL_MS) {
+    FAT_Sync(&file);
+    lastSync = Now();
+  }
+}
@@ -0,0 +1,26 @@
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include "channels.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Запись проходов спектра в SWEEPnnn.BIN на FAT-томе SPI флеш.
+ *
+ * Файл: "SWP1", далее кадры (little endian):
+ *   0xA5, u32 время (мс), u32 начало и u32 конец диапазона (10 Гц),
+ *   u8 число бинов N, u16 RSSI первого бина, N-1 дельт RSSI (i8).
+ * Дельта 0x80 — escape, за ней u16 абсолютное значение.
+ * Размер файла и FAT сбрасываются на флеш раз в 10 минут и при остановке.
+ */
+
+#define REC_FRAME_SYNC 0xA5
+#define REC_DELTA_ESCAPE 0x80
+
+bool REC_Start(void);
+void REC_Stop(void);
+bool REC_IsActive(void);
+void REC_AddSweep(const Band *b);
+
+#endif /* end of include guard: RECORDER_H */
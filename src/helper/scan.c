@@ -8,6 +8,7 @@
 #include "bands.h"
 #include "channels.h"
 #include "lootlist.h"
+#include "recorder.h"
 
 // =============================
 // Состояние сканирования
@@ -64,19 +65,20 @@ static void UpdateCPS() {
 }
 
 static uint16_t MeasureSignal(uint32_t frequency, bool precise) {
-  RADIO_SetParam(ctx, PARAM_PRECISE_F_CHANGE, precise, false);
-  RADIO_SetParam(ctx, PARAM_FREQUENCY, frequency, false);
-  RADIO_ApplySettings(ctx);
-  SYSTICK_DelayUs(precise ? scan.scanDelayUs : 50);
-  return RADIO_GetRSSI(ctx);
+  return RADIO_SweepMeasure(ctx, frequency, precise,
+                            precise ? scan.scanDelayUs : 50);
 }
 
 static void ApplyBandSettings() {
   vfo->msm.f = gCurrentBand.rxF;
 
+  RADIO_SweepEnd();
   RADIO_SetParam(ctx, PARAM_FREQUENCY, vfo->msm.f, false);
   RADIO_SetParam(ctx, PARAM_STEP, gCurrentBand.step, false);
   RADIO_ApplySettings(ctx);
+  if (scan.mode == SCAN_MODE_FREQUENCY || scan.mode == SCAN_MODE_ANALYSER) {
+    RADIO_SweepBegin(ctx, gCurrentBand.rxF, gCurrentBand.txF);
+  }
   SP_Init(&gCurrentBand);
   LogC(LOG_C_BRIGHT_YELLOW, "[SCANER] Bounds: %u .. %u", gCurrentBand.rxF,
        gCurrentBand.txF);
@@ -95,6 +97,7 @@ static void NextFrequency() {
   }
 
   if (vfo->msm.f > gCurrentBand.txF) {
+    REC_AddSweep(&gCurrentBand);
     if (scan.isMultiband) {
       BANDS_SelectBandRelativeByScanlist(true);
       ApplyBandSettings();
@@ -171,6 +174,7 @@ const char *SCAN_MODE_NAMES[] = {
 void SCAN_SetMode(ScanMode mode) {
   scan.mode = mode;
   Log("[SCAN] mode=%s", SCAN_MODE_NAMES[scan.mode]);
+  RADIO_SweepEnd();
 
   // Сброс состояния при смене режима
   scan.scanCycles = 0;
@@ -242,8 +246,8 @@ void SCAN_Init(bool multiband) {
 
   // CHANNELS_LoadBlacklistToLoot();
 
+  // REG_3F не трогаем: маску прерываний тонов задает setupToneDetection
   ApplyBandSettings();
-  BK4819_WriteRegister(BK4819_REG_3F, 0);
 }
 
 // =============================
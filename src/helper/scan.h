@@ -20,6 +20,7 @@ typedef enum {
 } ScanStateType;
 
 void SCAN_SetMode(ScanMode mode);
+ScanMode SCAN_GetMode(void);
 void SCAN_Init(bool multiband);
 void SCAN_setStartF(uint32_t f);
 void SCAN_setEndF(uint32_t f);
@@ -0,0 +1,122 @@
+#include "scheduler.h"
+#include "../driver/systick.h"
+#include "../driver/uart.h"
+#include <stddef.h>
+
+static SchedTask tasks[SCHED_TASKS_MAX];
+static uint32_t statsWindowStart;
+
+static SchedTask *find(SchedFn fn) {
+  for (uint8_t i = 0; i < SCHED_TASKS_MAX; ++i) {
+    if (tasks[i].fn == fn) {
+      return &tasks[i];
+    }
+  }
+  return NULL;
+}
+
+bool SCHED_Add(uint8_t owner, const char *name, SchedFn fn, uint16_t period,
+               SchedPriority prio) {
+  SchedTask *t = find(fn);
+  if (!t) {
+    t = find(NULL);
+  }
+  if (!t) {
+    LogC(LOG_C_RED, "[SCHED] No slot for %s", name);
+    return false;
+  }
+
+  // Слот не перемещается: задачи могут добавляться и сниматься
+  // изнутри SCHED_Run (смена приложения по кнопке)
+  t->name = name;
+  t->period = period;
+  t->prio = prio;
+  t->owner = owner;
+  t->next = Now();
+  t->cycles = 0;
+  t->maxCycles = 0;
+  t->load = 0;
+  t->fn = fn;
+  return true;
+}
+
+void SCHED_Remove(SchedFn fn) {
+  SchedTask *t = find(fn);
+  if (t) {
+    t->fn = NULL;
+  }
+}
+
+void SCHED_RemoveOwner(uint8_t owner) {
+  for (uint8_t i = 0; i < SCHED_TASKS_MAX; ++i) {
+    if (tasks[i].owner == owner) {
+      tasks[i].fn = NULL;
+    }
+  }
+}
+
+static void runTask(SchedTask *t) {
+  const SchedFn fn = t->fn;
+  const uint32_t now = Now();
+
+  if (t->period && (int32_t)(now - t->next) < 0) {
+    return;
+  }
+
+  const uint32_t start = SYSTICK_Cycles();
+  fn();
+  const uint32_t spent = SYSTICK_Cycles() - start;
+
+  // Задачу могли снять или заменить во время выполнения
+  if (t->fn != fn) {
+    return;
+  }
+
+  t->cycles += spent;
+  if (spent > t->maxCycles) {
+    t->maxCycles = spent;
+  }
+
+  if (t->period) {
+    t->next += t->period;
+    // Сильно опоздали — не догоняем пачкой запусков
+    if ((int32_t)(now - t->next) >= 0) {
+      t->next = now + t->period;
+    }
+  }
+}
+
+void SCHED_Run(void) {
+  for (uint8_t prio = 0; prio < SCHED_PRIO_COUNT; ++prio) {
+    for (uint8_t i = 0; i < SCHED_TASKS_MAX; ++i) {
+      if (tasks[i].fn && tasks[i].prio == prio) {
+        runTask(&tasks[i]);
+      }
+    }
+  }
+}
+
+void SCHED_UpdateStats(void) {
+  const uint32_t elapsed = Now() - statsWindowStart;
+  if (!elapsed) {
+    return;
+  }
+  const uint32_t cyclesPerPercent = elapsed * (SYSTICK_CYCLES_PER_MS / 100);
+
+  for (uint8_t i = 0; i < SCHED_TASKS_MAX; ++i) {
+    SchedTask *t = &tasks[i];
+    t->load = t->cycles / cyclesPerPercent;
+    t->cycles = 0;
+  }
+  statsWindowStart = Now();
+}
+
+const SchedTask *SCHED_GetTop(void) {
+  const SchedTask *top = NULL;
+  for (uint8_t i = 0; i < SCHED_TASKS_MAX; ++i) {
+    if (tasks[i].fn && (!top || tasks[i].load > top->load)) {
+      top = &tasks[i];
+    }
+  }
+  return top;
+}
@@ -0,0 +1,54 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Кооперативный планировщик главного цикла: фиксированная таблица задач
+// с периодом, дедлайном и приоритетом. За проход выполняются все задачи,
+// чей дедлайн наступил, от высшего приоритета к низшему.
+
+#define SCHED_TASKS_MAX 12
+
+// Владелец системных задач; задачи приложений снимаются при их deinit
+#define SCHED_OWNER_SYSTEM 0xFF
+
+typedef enum {
+  SCHED_PRIO_RADIO,
+  SCHED_PRIO_KEYS,
+  SCHED_PRIO_RENDER,
+  SCHED_PRIO_HOUSEKEEPING,
+
+  SCHED_PRIO_COUNT,
+} SchedPriority;
+
+typedef void (*SchedFn)(void);
+
+typedef struct {
+  const char *name;
+  SchedFn fn;      // NULL — слот свободен
+  uint16_t period; // мс, 0 — каждый проход
+  uint8_t prio;
+  uint8_t owner;
+  uint32_t next; // дедлайн следующего запуска
+
+  // Учет времени: такты SysTick за текущее окно, пик за вызов
+  uint32_t cycles;
+  uint32_t maxCycles;
+  uint8_t load; // % CPU за прошлое окно
+} SchedTask;
+
+// Повторная регистрация той же функции обновляет параметры задачи
+bool SCHED_Add(uint8_t owner, const char *name, SchedFn fn, uint16_t period,
+               SchedPriority prio);
+void SCHED_Remove(SchedFn fn);
+void SCHED_RemoveOwner(uint8_t owner);
+
+void SCHED_Run(void);
+
+// Закрыть окно учета времени (раз в секунду)
+void SCHED_UpdateStats(void);
+// Задача с наибольшей нагрузкой за прошлое окно или NULL
+const SchedTask *SCHED_GetTop(void);
+
+#endif /* end of include guard: SCHEDULER_H */
@@ -0,0 +1,540 @@
+#include "vfs.h"
+#include "../driver/fat_fs.h"
+#include "../driver/systick.h"
+#include "../driver/uart.h"
+#include "../external/CMSIS/Device/PY32F071/Include/py32f071xB.h"
+#include "../external/printf/printf.h"
+#include "../misc.h"
+#include "../radio.h"
+#include "../settings.h"
+#include "bands.h"
+#include "channels.h"
+#include <string.h>
+
+// Файлы закреплены за последними кластерами тома непрерывными цепочками,
+// поэтому LBA файла вычисляется без обхода FAT
+#define VFS_CH_CLUSTERS                                                        \
+  ((SCANLIST_MAX * CH_SIZE + FAT_CLUSTER_SIZE - 1) / FAT_CLUSTER_SIZE)
+#define VFS_BANDS_CLUSTERS 1
+#define VFS_FIRST_CLUSTER                                                      \
+  (FAT_CLUSTER_COUNT + 2 - VFS_CH_CLUSTERS - VFS_BANDS_CLUSTERS)
+
+#define VFS_LINE_MAX 128
+#define VFS_CSV_FIELDS 13
+
+typedef struct VFile VFile;
+
+struct VFile {
+  const char *name;
+  uint16_t cluster;
+  uint16_t clusters;
+  uint32_t lba;
+  int16_t slot;        // запись каталога
+  bool attached;       // запись каталога указывает на наши кластеры
+  uint32_t importSig;  // файл хоста, импортированный последним
+  uint8_t written[VFS_CH_CLUSTERS]; // бит на LBA, перезаписанный хостом
+  void (*synth)(uint32_t offset, uint8_t *buf, uint16_t size);
+  void (*import)(VFile *v, FAT_File *f, uint32_t size);
+};
+
+static void chSynth(uint32_t offset, uint8_t *buf, uint16_t size);
+static void chImport(VFile *v, FAT_File *f, uint32_t size);
+static void bandsSynth(uint32_t offset, uint8_t *buf, uint16_t size);
+static void bandsImport(VFile *v, FAT_File *f, uint32_t size);
+
+static VFile files[] = {
+    {
+        .name = "CHANNELSBIN",
+        .cluster = VFS_FIRST_CLUSTER,
+        .clusters = VFS_CH_CLUSTERS,
+        .synth = chSynth,
+        .import = chImport,
+    },
+    {
+        .name = "BANDS   CSV",
+        .cluster = VFS_FIRST_CLUSTER + VFS_CH_CLUSTERS,
+        .clusters = VFS_BANDS_CLUSTERS,
+        .synth = bandsSynth,
+        .import = bandsImport,
+    },
+};
+
+static volatile bool pending;
+static volatile uint32_t lastWrite;
+static bool bandsChanged;
+
+static const char CSV_HEADER[] =
+    "slot,name,start,end,step,mod,bw,radio,power,sq_type,sq,gain,scanlists\r\n";
+
+static bool isWritten(VFile *v, uint32_t lba) {
+  uint32_t i = lba - v->lba;
+  return v->written[i / 8] & (1 << (i % 8));
+}
+
+static VFile *fileByLba(uint32_t lba) {
+  for (uint8_t i = 0; i < ARRAY_SIZE(files); ++i) {
+    VFile *v = &files[i];
+    if (lba >= v->lba && lba < v->lba + v->clusters * FAT_SECTORS_PER_CLUSTER) {
+      return v;
+    }
+  }
+  return NULL;
+}
+
+// CHANNELS.BIN
+
+static void chSynth(uint32_t offset, uint8_t *buf, uint16_t size) {
+  CH ch;
+  while (size) {
+    uint16_t i = offset / CH_SIZE;
+    uint8_t o = offset % CH_SIZE;
+    uint16_t len = MIN(CH_SIZE - o, size);
+    if (i < CHANNELS_GetCountMax()) {
+      CHANNELS_Load(i, &ch);
+      memcpy(buf, (uint8_t *)&ch + o, len);
+    } else {
+      memset(buf, 0, len);
+    }
+    buf += len;
+    offset += len;
+    size -= len;
+  }
+}
+
+// Чтение файла при импорте: свой файл — по LBA (перезаписанные хостом
+// берутся с флеша, остальные синтезируются), чужой — по цепочке FAT
+static uint32_t vfsRead(VFile *v, FAT_File *f, uint32_t offset, void *buf,
+                        uint16_t size) {
+  if (f) {
+    return FAT_Read(f, buf, size);
+  }
+
+  uint8_t *p = buf;
+  uint16_t left = size;
+  while (left) {
+    uint32_t lba = v->lba + offset / FAT_SECTOR_SIZE;
+    uint16_t o = offset % FAT_SECTOR_SIZE;
+    uint16_t len = MIN(FAT_SECTOR_SIZE - o, left);
+    if (isWritten(v, lba)) {
+      PY25Q16_ReadBuffer(FAT_BASE_ADDR + lba * FAT_SECTOR_SIZE + o, p, len);
+    } else {
+      v->synth(offset, p, len);
+    }
+    p += len;
+    offset += len;
+    left -= len;
+  }
+  return size;
+}
+
+static void chImport(VFile *v, FAT_File *f, uint32_t size) {
+  CH ch;
+  uint16_t max = CHANNELS_GetCountMax();
+  uint16_t n = 0;
+
+  // Пакетная запись сама пропускает совпадающие записи, стирание — только
+  // для 4 КБ блоков, где что-то поменялось
+  for (; n < max && (n + 1) * CH_SIZE <= size; ++n) {
+    if (vfsRead(v, f, n * CH_SIZE, &ch, CH_SIZE) != CH_SIZE) {
+      break;
+    }
+    CHANNELS_SaveBatch(n, &ch);
+  }
+  CHANNELS_CommitBatch();
+  Log("[VFS] CHANNELS.BIN: %u records", n);
+}
+
+// BANDS.CSV
+
+static const char *nameOr(const char *name) { return name ? name : "?"; }
+
+static uint8_t csvLine(uint8_t i, char *s) {
+  if (i == 0) {
+    strcpy(s, CSV_HEADER);
+    return sizeof(CSV_HEADER) - 1;
+  }
+
+  uint16_t mr = BANDS_GetMR(i - 1);
+  Band b;
+  char name[sizeof(b.name) + 1];
+  CHANNELS_Load(mr, &b);
+
+  uint8_t n = 0;
+  for (; n < sizeof(b.name) && b.name[n]; ++n) {
+    char c = b.name[n];
+    name[n] = (c == ',' || c < ' ' || c > '~') ? ' ' : c;
+  }
+  name[n] = '\0';
+
+  uint16_t step = StepFrequencyTable[b.step % ARRAY_SIZE(StepFrequencyTable)];
+
+  int len = snprintf(
+      s, VFS_LINE_MAX, "%u,%s,%u.%05u,%u.%05u,%u.%02u,%s,%u,%s,%s,%s,%u,%u,%u\r\n",
+      mr, name, b.rxF / MHZ, b.rxF % MHZ, b.txF / MHZ, b.txF % MHZ,
+      step / KHZ, step % KHZ, nameOr(MOD_NAMES_BK4819[b.modulation % 8]),
+      b.bw, nameOr(RADIO_NAMES[b.radio % 3]), TX_POWER_NAMES[b.power],
+      SQ_TYPE_NAMES[b.squelch.type], b.squelch.value, b.gainIndex,
+      b.scanlists);
+  return MIN(len, VFS_LINE_MAX - 1);
+}
+
+// Длины строк снимаются при подключении, после импорта и после правки
+// диапазона на радио (VFS_BandsChanged): чтение сектора из прерывания USB
+// форматирует только попавшие в него строки
+static uint8_t csvLen[BANDS_COUNT_MAX + 1];
+static uint8_t csvCount;
+static uint32_t csvSize; // размер в записи каталога
+
+static uint32_t csvIndex(void) {
+  char line[VFS_LINE_MAX];
+  uint32_t size = 0;
+  csvCount = BANDS_GetCount() + 1;
+  for (uint8_t i = 0; i < csvCount; ++i) {
+    csvLen[i] = csvLine(i, line);
+    size += csvLen[i];
+  }
+  return size;
+}
+
+// Диапазон изменили после снятия индекса: строка подгоняется под прежнюю
+// длину, чтобы не сдвигать остальные
+static void csvFit(uint8_t i, char *s) {
+  uint8_t len = csvLine(i, s);
+  uint8_t slot = csvLen[i];
+  if (len != slot && slot >= 2) {
+    if (len < slot) {
+      memset(s + len - 2, ' ', slot - len);
+    }
+    memcpy(s + slot - 2, "\r\n", 2);
+  }
+}
+
+static void bandsSynth(uint32_t offset, uint8_t *buf, uint16_t size) {
+  char line[VFS_LINE_MAX];
+  uint32_t pos = 0;
+  uint32_t end = offset + size;
+
+  // Хвост за текстом (после импорта файл мог укоротиться) — переводы строк
+  memset(buf, '\n', size);
+  for (uint8_t i = 0; i < csvCount && pos < end; ++i) {
+    uint8_t len = csvLen[i];
+    if (pos + len > offset) {
+      csvFit(i, line);
+      uint32_t from = pos > offset ? pos : offset;
+      uint32_t to = MIN(pos + len, end);
+      memcpy(buf + (from - offset), line + (from - pos), to - from);
+    }
+    pos += len;
+  }
+}
+
+static char *trim(char *s) {
+  while (*s == ' ' || *s == '\t') {
+    s++;
+  }
+  char *e = s + strlen(s);
+  while (e > s && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\r')) {
+    *--e = '\0';
+  }
+  return s;
+}
+
+static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+static uint32_t parseU(const char *s) {
+  uint32_t v = 0;
+  while (isDigit(*s)) {
+    v = v * 10 + (*s++ - '0');
+  }
+  return v;
+}
+
+// "145.5" при decimals=5 -> 14550000
+static uint32_t parseFixed(const char *s, uint8_t decimals) {
+  uint32_t v = parseU(s);
+  while (isDigit(*s)) {
+    s++;
+  }
+  if (*s == '.') {
+    s++;
+  }
+  for (uint8_t i = 0; i < decimals; ++i) {
+    v = v * 10 + (isDigit(*s) ? (*s++ - '0') : 0);
+  }
+  return v;
+}
+
+static int8_t findName(const char **names, uint8_t count, const char *s) {
+  for (uint8_t i = 0; i < count; ++i) {
+    if (names[i] && strcmp(names[i], s) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// Строка CSV: slot задает запись MR, существующий диапазон обновляется,
+// пустой слот становится новым диапазоном. Каналы и слоты VFO (две
+// последние записи) не трогаются. Неизвестные значения не трогают поле
+static bool bandsImportLine(char *line) {
+  char *f[VFS_CSV_FIELDS];
+  uint8_t n = 0;
+
+  for (char *p = line; p && n < VFS_CSV_FIELDS;) {
+    f[n++] = p;
+    p = strchr(p, ',');
+    if (p) {
+      *p++ = '\0';
+    }
+  }
+  for (uint8_t i = 0; i < n; ++i) {
+    f[i] = trim(f[i]);
+  }
+
+  if (n < 4 || !isDigit(f[0][0])) {
+    return false; // заголовок, комментарий или пустая строка
+  }
+
+  uint16_t mr = parseU(f[0]);
+  if (mr >= CHANNELS_GetCountMax() - 2) {
+    return false;
+  }
+
+  Band b;
+  CHANNELS_Load(mr, &b);
+  if (b.meta.type != TYPE_BAND && b.meta.type != TYPE_EMPTY) {
+    Log("[VFS] BANDS.CSV: slot %u is not a band, skipped", mr);
+    return false;
+  }
+  if (b.meta.type == TYPE_EMPTY) {
+    b = defaultBand;
+    b.meta.readonly = false;
+    b.meta.type = TYPE_BAND;
+  }
+
+  memset(b.name, 0, sizeof(b.name));
+  strncpy(b.name, f[1], sizeof(b.name));
+  b.rxF = parseFixed(f[2], 5);
+  b.txF = parseFixed(f[3], 5);
+
+  int8_t i;
+  if (n > 4) {
+    uint32_t step = parseFixed(f[4], 2);
+    for (uint8_t s = 0; s < ARRAY_SIZE(StepFrequencyTable); ++s) {
+      if (StepFrequencyTable[s] == step) {
+        b.step = s;
+      }
+    }
+  }
+  if (n > 5 && (i = findName(MOD_NAMES_BK4819, 8, f[5])) >= 0) {
+    b.modulation = i;
+  }
+  if (n > 6 && isDigit(f[6][0])) {
+    b.bw = parseU(f[6]);
+  }
+  if (n > 7 && (i = findName(RADIO_NAMES, 3, f[7])) >= 0) {
+    b.radio = i;
+  }
+  if (n > 8 && (i = findName(TX_POWER_NAMES, 4, f[8])) >= 0) {
+    b.power = i;
+  }
+  if (n > 9 && (i = findName(SQ_TYPE_NAMES, 4, f[9])) >= 0) {
+    b.squelch.type = i;
+  }
+  if (n > 10 && isDigit(f[10][0])) {
+    b.squelch.value = parseU(f[10]);
+  }
+  if (n > 11 && isDigit(f[11][0])) {
+    b.gainIndex = parseU(f[11]);
+  }
+  if (n > 12 && isDigit(f[12][0])) {
+    b.scanlists = parseU(f[12]);
+  }
+
+  CHANNELS_SaveBatch(mr, &b);
+  return true;
+}
+
+static void bandsImport(VFile *v, FAT_File *f, uint32_t size) {
+  char line[VFS_LINE_MAX];
+  uint8_t chunk[32];
+  uint8_t len = 0;
+  uint16_t count = 0;
+
+  for (uint32_t offset = 0; offset < size;) {
+    uint16_t n = vfsRead(v, f, offset, chunk, MIN(sizeof(chunk), size - offset));
+    if (!n) {
+      break;
+    }
+    offset += n;
+
+    for (uint16_t k = 0; k < n; ++k) {
+      char c = chunk[k];
+      if (c == '\n' || (offset == size && k == n - 1)) {
+        if (c != '\n' && len < VFS_LINE_MAX - 1) {
+          line[len++] = c;
+        }
+        line[len] = '\0';
+        count += bandsImportLine(line);
+        len = 0;
+      } else if (len < VFS_LINE_MAX - 1) {
+        line[len++] = c;
+      }
+    }
+  }
+  CHANNELS_CommitBatch();
+  Log("[VFS] BANDS.CSV: %u bands", count);
+}
+
+// Подпись файла хоста: по ней повторный импорт того же файла пропускается
+static uint32_t entrySig(const fat_dir_entry_t *e) {
+  return e->file_size ^ ((uint32_t)e->fst_clus_lo << 20) ^
+         ((uint32_t)e->wrt_date << 16) ^ e->wrt_time;
+}
+
+static bool importFile(VFile *v) {
+  fat_dir_entry_t e;
+  if (!FAT_Stat(v->name, &e) || !e.file_size) {
+    return false;
+  }
+
+  if (e.fst_clus_lo == v->cluster) {
+    bool dirty = false;
+    for (uint8_t i = 0; i < ARRAY_SIZE(v->written); ++i) {
+      dirty |= v->written[i] != 0;
+    }
+    if (!dirty) {
+      return false;
+    }
+    v->import(v, NULL, MIN(e.file_size, v->clusters * FAT_CLUSTER_SIZE));
+    memset(v->written, 0, sizeof(v->written));
+    return true;
+  }
+
+  // Хост перезаписал файл в другие кластеры: читаем по цепочке FAT
+  uint32_t sig = entrySig(&e);
+  if (sig == v->importSig) {
+    return false;
+  }
+  FAT_File f;
+  if (!FAT_Open(&f, v->name, false)) {
+    return false;
+  }
+  v->import(v, &f, e.file_size);
+  v->importSig = sig;
+  return true;
+}
+
+void VFS_Init(void) {
+  for (uint8_t i = 0; i < ARRAY_SIZE(files); ++i) {
+    VFile *v = &files[i];
+    uint32_t size = i == 0 ? CHANNELS_GetCountMax() * CH_SIZE : csvIndex();
+    if (i == 1) {
+      csvSize = size;
+    }
+
+    v->lba = FAT_DATA_SECTOR + (v->cluster - 2) * FAT_SECTORS_PER_CLUSTER;
+    v->slot = FAT_Pin(v->name, v->cluster, v->clusters, size);
+    v->attached = v->slot >= 0;
+    memset(v->written, 0, sizeof(v->written));
+  }
+}
+
+void VFS_BandsChanged(void) { bandsChanged = true; }
+
+// Диапазон изменен на радио: длины строк и размер BANDS.CSV в каталоге
+// обновляются, пока хост не перезаписал файл своим
+static void reindexBands(void) {
+  VFile *v = &files[1];
+  uint32_t usbEnabled = NVIC_GetEnableIRQ(USB_IRQn);
+  NVIC_DisableIRQ(USB_IRQn);
+
+  uint32_t size = csvIndex();
+  if (v->attached && size != csvSize) {
+    v->slot = FAT_Pin(v->name, v->cluster, v->clusters, size);
+    v->attached = v->slot >= 0;
+  }
+  csvSize = size;
+
+  if (usbEnabled) {
+    NVIC_EnableIRQ(USB_IRQn);
+  }
+}
+
+void VFS_Update(void) {
+  if (bandsChanged) {
+    bandsChanged = false;
+    reindexBands();
+  }
+
+  if (!pending || Now() - lastWrite < VFS_IDLE_MS) {
+    return;
+  }
+  pending = false;
+
+  // Импорт идет через служебный блок флеша, его же использует кеш записи
+  // MSC: на время импорта хост не обслуживается
+  uint32_t usbEnabled = NVIC_GetEnableIRQ(USB_IRQn);
+  NVIC_DisableIRQ(USB_IRQn);
+  FAT_Flush();
+
+  bool imported = false;
+  for (uint8_t i = 0; i < ARRAY_SIZE(files); ++i) {
+    imported |= importFile(&files[i]);
+  }
+
+  if (imported) {
+    BANDS_Load();
+    CHANNELS_ReloadScanlist();
+    csvSize = csvIndex();
+  }
+
+  if (usbEnabled) {
+    NVIC_EnableIRQ(USB_IRQn);
+  }
+}
+
+bool VFS_Read(uint32_t lba, uint8_t *buf) {
+  VFile *v = fileByLba(lba);
+  if (!v || !v->attached || isWritten(v, lba)) {
+    return false;
+  }
+  v->synth((lba - v->lba) * FAT_SECTOR_SIZE, buf, FAT_SECTOR_SIZE);
+  return true;
+}
+
+void VFS_Write(uint32_t lba, const uint8_t *buf) {
+  lastWrite = Now();
+  pending = true;
+
+  // Запись корневого каталога: следим, указывает ли запись файла на
+  // закрепленные кластеры (хост мог удалить файл или перенести данные)
+  if (lba >= FAT_ROOT_DIR_SECTOR && lba < FAT_DATA_SECTOR) {
+    const uint8_t perLba = FAT_SECTOR_SIZE / sizeof(fat_dir_entry_t);
+    int16_t first = (lba - FAT_ROOT_DIR_SECTOR) * perLba;
+    const fat_dir_entry_t *e = (const fat_dir_entry_t *)buf;
+
+    for (uint8_t i = 0; i < ARRAY_SIZE(files); ++i) {
+      VFile *v = &files[i];
+      bool found = false;
+      for (uint8_t k = 0; k < perLba; ++k) {
+        if (memcmp(e[k].name, v->name, 11) == 0) {
+          v->slot = first + k;
+          v->attached = e[k].fst_clus_lo == v->cluster;
+          found = true;
+          break;
+        }
+      }
+      if (!found && v->slot >= first && v->slot < first + perLba) {
+        v->attached = false;
+      }
+    }
+    return;
+  }
+
+  VFile *v = fileByLba(lba);
+  if (v) {
+    uint32_t i = lba - v->lba;
+    v->written[i / 8] |= 1 << (i % 8);
+  }
+}
@@ -0,0 +1,24 @@
+#ifndef VFS_H
+#define VFS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Виртуальные файлы на MSC-томе: CHANNELS.BIN (сырые записи MR) и
+// BANDS.CSV (диапазоны). Содержимое синтезируется при чтении хостом,
+// записанное хостом импортируется пакетно после паузы в записи.
+
+// Сколько мс без записей MSC ждать перед импортом
+#define VFS_IDLE_MS 2000
+
+void VFS_Init(void);
+void VFS_Update(void);
+// Диапазон добавлен, изменен или удален на радио: BANDS.CSV
+// переиндексируется в VFS_Update
+void VFS_BandsChanged(void);
+
+// Вызываются из прерывания USB (usbd_msc_if.c)
+bool VFS_Read(uint32_t lba, uint8_t *buf);
+void VFS_Write(uint32_t lba, const uint8_t *buf);
+
+#endif /* end of include guard: VFS_H */
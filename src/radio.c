@@ -16,6 +16,7 @@
 #include "helper/channels.h"
 #include "helper/lootlist.h"
 #include "helper/measurements.h"
+#include "helper/rds.h"
 #include "misc.h"
 #include "settings.h"
 #include <stdint.h>
@@ -464,153 +465,186 @@ void RADIO_SwitchAudioToVFO(RadioState *state, uint8_t vfo_index) {
   // AUDIO_SetVolume(vfo->context.volume);
 }
 
-static bool setParamBK4819(VFOContext *ctx, ParamType p) {
-  switch (p) {
-  case PARAM_GAIN:
-    BK4819_SetAGC(ctx->modulation != MOD_AM, ctx->gain);
-    return true;
-  case PARAM_BANDWIDTH:
-    BK4819_SetFilterBandwidth(ctx->bandwidth);
-    return true;
-  case PARAM_SQUELCH_VALUE:
-    BK4819_Squelch(ctx->squelch.value, gSettings.sqlOpenTime,
-                   gSettings.sqlCloseTime);
-    return true;
-  case PARAM_SQUELCH_TYPE:
-    BK4819_SquelchType(ctx->squelch.type);
-    return true;
-  case PARAM_MODULATION:
-    BK4819_SetModulation(ctx->modulation);
-    return true;
-  case PARAM_FREQUENCY:
-    if (ctx->filter == FILTER_AUTO) {
-      Filter filter = (ctx->frequency < SETTINGS_GetFilterBound()) ? FILTER_VHF
-                                                                   : FILTER_UHF;
-      BK4819_SelectFilterEx(filter);
-    }
-    BK4819_TuneTo(ctx->frequency,
-                  ctx->preciseFChange); // TODO: check if SetFreq needed
-    return true;
-  /* case PARAM_TX_POWER_AMPLIFIER:
-    BK4819_ToggleGpioOut(BK4819_GPIO1_PIN29_PA_ENABLE,
-                         ctx->tx_state.pa_enabled);
-    return true;
-  case PARAM_TX_POWER:
-    BK4819_SetupPowerAmplifier(ctx->tx_state.power_level,
-                               ctx->tx_state.frequency);
-    return true; */
-  case PARAM_AFC:
-    BK4819_SetAFC(ctx->afc);
-    return true;
-  case PARAM_AFC_SPD:
-    BK4819_SetAFCSpeed(ctx->afc_speed);
-    return true;
-  case PARAM_XTAL:
-    BK4819_XtalSet(ctx->xtal);
-    return true;
-  case PARAM_FILTER: {
-    Filter filter = ctx->filter;
-    if (ctx->filter == FILTER_AUTO) {
-      filter = (ctx->frequency < SETTINGS_GetFilterBound()) ? FILTER_VHF
-                                                            : FILTER_UHF;
-    }
-    BK4819_SelectFilterEx(filter);
+// Планы применения параметров: для каждой пары (радио, параметр) — функция,
+// пишущая только затронутые регистры. Пустой элемент — параметр этим радио
+// не применяется и остается dirty до смены радио.
+typedef void (*ParamApply)(VFOContext *ctx);
+
+static Filter autoFilter(const VFOContext *ctx) {
+  return ctx->frequency < SETTINGS_GetFilterBound() ? FILTER_VHF : FILTER_UHF;
+}
+
+// REG_49, REG_7B (+REG_13/14 для AM)
+static void bk4819Gain(VFOContext *ctx) {
+  BK4819_SetAGC(ctx->modulation != MOD_AM, ctx->gain);
+}
+
+static void bk4819Bandwidth(VFOContext *ctx) {
+  BK4819_SetFilterBandwidth(ctx->bandwidth);
+}
+
+static void bk4819SquelchValue(VFOContext *ctx) {
+  BK4819_Squelch(ctx->squelch.value, gSettings.sqlOpenTime,
+                 gSettings.sqlCloseTime);
+}
+
+static void bk4819SquelchType(VFOContext *ctx) {
+  BK4819_SquelchType(ctx->squelch.type);
+}
+
+static void bk4819Modulation(VFOContext *ctx) {
+  BK4819_SetModulation(ctx->modulation);
+}
+
+// REG_38/REG_39 (только изменившиеся половины), REG_30 — перекалибровка VCO,
+// REG_33 — только при смене фильтра
+static void bk4819Frequency(VFOContext *ctx) {
+  if (ctx->filter == FILTER_AUTO) {
+    BK4819_SelectFilterEx(autoFilter(ctx));
   }
-    return true;
-  case PARAM_MIC:
-    BK4819_SetRegValue(RS_MIC, ctx->mic);
-    return true;
-  case PARAM_DEV:
-    BK4819_SetRegValue(RS_DEV, ctx->dev);
-    return true;
-  case PARAM_VOLUME:
-    /* BK4819_SetRegValue(RS_AF_DAC_GAIN,
-                       ConvertDomain(ctx->volume, 0, 100, 0, 15)); */
-    return true;
-  case PARAM_RADIO:
-  case PARAM_PRECISE_F_CHANGE:
-  case PARAM_STEP:
-  case PARAM_POWER:
-  case PARAM_TX_OFFSET:
-  case PARAM_TX_OFFSET_DIR:
-  case PARAM_TX_STATE:
-  case PARAM_TX_FREQUENCY:
-  case PARAM_TX_FREQUENCY_FACT:
-  case PARAM_TX_POWER:
-  case PARAM_TX_POWER_AMPLIFIER:
-  case PARAM_RX_CODE:
-  case PARAM_TX_CODE:
-  case PARAM_RSSI:
-  case PARAM_NOISE:
-  case PARAM_GLITCH:
-  case PARAM_SNR:
-  case PARAM_COUNT:
-    break;
+  BK4819_TuneTo(ctx->frequency,
+                ctx->preciseFChange); // TODO: check if SetFreq needed
+}
+
+static void bk4819Afc(VFOContext *ctx) { BK4819_SetAFC(ctx->afc); }
+
+static void bk4819AfcSpeed(VFOContext *ctx) {
+  BK4819_SetAFCSpeed(ctx->afc_speed);
+}
+
+static void bk4819Xtal(VFOContext *ctx) { BK4819_XtalSet(ctx->xtal); }
+
+static void bk4819Filter(VFOContext *ctx) {
+  BK4819_SelectFilterEx(ctx->filter == FILTER_AUTO ? autoFilter(ctx)
+                                                   : ctx->filter);
+}
+
+static void bk4819Mic(VFOContext *ctx) {
+  BK4819_SetRegValue(RS_MIC, ctx->mic);
+}
+
+static void bk4819Dev(VFOContext *ctx) {
+  BK4819_SetRegValue(RS_DEV, ctx->dev);
+}
+
+static void bk4819Volume(VFOContext *ctx) {
+  /* BK4819_SetRegValue(RS_AF_DAC_GAIN,
+                     ConvertDomain(ctx->volume, 0, 100, 0, 15)); */
+}
+
+static void siRsqInvalidate(void);
+
+static void si4732Frequency(VFOContext *ctx) {
+  SI47XX_TuneTo(ctx->frequency);
+  siRsqInvalidate();
+  RDS_Reset();
+}
+
+static void si4732Modulation(VFOContext *ctx) {
+  SI47XX_SwitchMode((SI47XX_MODE)ctx->modulation);
+  siRsqInvalidate();
+  RDS_Reset();
+}
+
+static void si4732Gain(VFOContext *ctx) {
+  SI47XX_SetAutomaticGainControl(ctx->gain == 0,
+                                 ctx->gain == 0 ? 0 : ctx->gain);
+}
+
+static void si4732Bandwidth(VFOContext *ctx) {
+  if (RADIO_IsSSB(ctx)) {
+    SI47XX_SetSsbBandwidth(ctx->bandwidth);
+  } else {
+    SI47XX_SetBandwidth(ctx->bandwidth, true);
   }
-  return false;
 }
 
-static bool setParamSI4732(VFOContext *ctx, ParamType p) {
-  switch (p) {
-  case PARAM_FREQUENCY:
-    SI47XX_TuneTo(ctx->frequency);
-    return true;
-  case PARAM_MODULATION:
-    SI47XX_SwitchMode((SI47XX_MODE)ctx->modulation);
-    return true;
-  case PARAM_GAIN:
-    SI47XX_SetAutomaticGainControl(ctx->gain == 0,
-                                   ctx->gain == 0 ? 0 : ctx->gain);
-    return true;
-  case PARAM_BANDWIDTH:
-    if (RADIO_IsSSB(ctx)) {
-      SI47XX_SetSsbBandwidth(ctx->bandwidth);
-    } else {
-      SI47XX_SetBandwidth(ctx->bandwidth, true);
+static void si4732Volume(VFOContext *ctx) {
+  SI47XX_SetVolume(ConvertDomain(ctx->volume, 0, 100, 0, 63));
+}
+
+static void bk1080Frequency(VFOContext *ctx) {
+  BK1080_SetFrequency(ctx->frequency);
+}
+
+/* PARAM_TX_POWER_AMPLIFIER:
+  BK4819_ToggleGpioOut(BK4819_GPIO1_PIN29_PA_ENABLE, ctx->tx_state.pa_enabled);
+PARAM_TX_POWER:
+  BK4819_SetupPowerAmplifier(ctx->tx_state.power_level,
+                             ctx->tx_state.frequency); */
+static const ParamApply PLAN_BK4819[PARAM_COUNT] = {
+    [PARAM_GAIN] = bk4819Gain,
+    [PARAM_BANDWIDTH] = bk4819Bandwidth,
+    [PARAM_SQUELCH_VALUE] = bk4819SquelchValue,
+    [PARAM_SQUELCH_TYPE] = bk4819SquelchType,
+    [PARAM_MODULATION] = bk4819Modulation,
+    [PARAM_AFC] = bk4819Afc,
+    [PARAM_AFC_SPD] = bk4819AfcSpeed,
+    [PARAM_XTAL] = bk4819Xtal,
+    [PARAM_FILTER] = bk4819Filter,
+    [PARAM_MIC] = bk4819Mic,
+    [PARAM_DEV] = bk4819Dev,
+    [PARAM_VOLUME] = bk4819Volume,
+    [PARAM_FREQUENCY] = bk4819Frequency,
+};
+
+static const ParamApply PLAN_SI4732[PARAM_COUNT] = {
+    [PARAM_MODULATION] = si4732Modulation,
+    [PARAM_GAIN] = si4732Gain,
+    [PARAM_BANDWIDTH] = si4732Bandwidth,
+    [PARAM_VOLUME] = si4732Volume,
+    [PARAM_FREQUENCY] = si4732Frequency,
+};
+
+static const ParamApply PLAN_BK1080[PARAM_COUNT] = {
+    [PARAM_FREQUENCY] = bk1080Frequency,
+};
+
+static const ParamApply *const RADIO_PLANS[] = {
+    [RADIO_BK4819] = PLAN_BK4819,
+    [RADIO_BK1080] = PLAN_BK1080,
+    [RADIO_SI4732] = PLAN_SI4732,
+};
+
+// Параметры без записи в регистры: снимаются сразу
+static const ParamMask PARAMS_NO_APPLY =
+    PARAM_BIT(PARAM_STEP) | PARAM_BIT(PARAM_POWER) |
+    PARAM_BIT(PARAM_TX_FREQUENCY) | PARAM_BIT(PARAM_TX_OFFSET) |
+    PARAM_BIT(PARAM_TX_OFFSET_DIR) | PARAM_BIT(PARAM_TX_STATE) |
+    PARAM_BIT(PARAM_TX_CODE) | PARAM_BIT(PARAM_RX_CODE) |
+    PARAM_BIT(PARAM_RSSI) | PARAM_BIT(PARAM_NOISE) | PARAM_BIT(PARAM_GLITCH) |
+    PARAM_BIT(PARAM_SNR) | PARAM_BIT(PARAM_PRECISE_F_CHANGE);
+
+// Маски параметров, которые есть в плане радио (строятся один раз)
+static ParamMask planMask[ARRAY_SIZE(RADIO_PLANS)];
+
+static ParamMask getPlanMask(Radio r) {
+  if (!planMask[r]) {
+    for (uint8_t p = 0; p < PARAM_COUNT; ++p) {
+      if (RADIO_PLANS[r][p]) {
+        planMask[r] |= PARAM_BIT(p);
+      }
     }
-    return true;
-  case PARAM_VOLUME:
-    SI47XX_SetVolume(ConvertDomain(ctx->volume, 0, 100, 0, 63));
-    return true;
-  case PARAM_RADIO:
-  case PARAM_PRECISE_F_CHANGE:
-  case PARAM_STEP:
-  case PARAM_POWER:
-  case PARAM_SQUELCH_TYPE:
-  case PARAM_SQUELCH_VALUE:
-  case PARAM_TX_OFFSET:
-  case PARAM_TX_OFFSET_DIR:
-  case PARAM_TX_STATE:
-  case PARAM_TX_FREQUENCY:
-  case PARAM_TX_FREQUENCY_FACT:
-  case PARAM_TX_POWER:
-  case PARAM_TX_POWER_AMPLIFIER:
-  case PARAM_RX_CODE:
-  case PARAM_TX_CODE:
-  case PARAM_AFC:
-  case PARAM_AFC_SPD:
-  case PARAM_DEV:
-  case PARAM_MIC:
-  case PARAM_XTAL:
-  case PARAM_FILTER:
-  case PARAM_RSSI:
-  case PARAM_NOISE:
-  case PARAM_GLITCH:
-  case PARAM_SNR:
-  case PARAM_COUNT:
-    break;
   }
-  return false;
+  return planMask[r];
 }
 
-static bool setParamBK1080(VFOContext *ctx, ParamType p) {
-  if (p == PARAM_FREQUENCY) {
-    BK1080_SetFrequency(ctx->frequency);
-    return true;
+// RSQ SI4732 — полный I2C обмен с ожиданием CTS: RSSI, SNR и multipath
+// берутся из одного ответа, который живет SQL_DELAY или до перестройки
+static uint32_t siRsqTime;
+static bool siRsqValid;
+
+static const RSQStatus *siRsq(void) {
+  if (!siRsqValid || Now() - siRsqTime >= SQL_DELAY) {
+    RSQ_GET();
+    siRsqTime = Now();
+    siRsqValid = true;
   }
-  return false;
+  return &rsqStatus;
 }
 
+static void siRsqInvalidate(void) { siRsqValid = false; }
+
 uint16_t RADIO_GetRSSI(const VFOContext *ctx) {
   switch (ctx->radio_type) {
   case RADIO_BK4819:
@@ -618,11 +652,7 @@ uint16_t RADIO_GetRSSI(const VFOContext *ctx) {
   case RADIO_BK1080:
     return gShowAllRSSI ? BK1080_GetRSSI() : 0;
   case RADIO_SI4732:
-    if (gShowAllRSSI) {
-      RSQ_GET();
-      return rsqStatus.resp.RSSI;
-    }
-    return 0;
+    return gShowAllRSSI ? siRsq()->resp.RSSI : 0;
   default:
     return 0;
   }
@@ -635,11 +665,7 @@ uint8_t RADIO_GetSNR(const VFOContext *ctx) {
   case RADIO_BK1080:
     return gShowAllRSSI ? BK1080_GetSNR() : 0;
   case RADIO_SI4732:
-    if (gShowAllRSSI) {
-      RSQ_GET();
-      return rsqStatus.resp.SNR;
-    }
-    return 0;
+    return gShowAllRSSI ? siRsq()->resp.SNR : 0;
   default:
     return 0;
   }
@@ -653,6 +679,33 @@ uint8_t RADIO_GetGlitch(const VFOContext *ctx) {
   return ctx->radio_type == RADIO_BK4819 ? BK4819_GetGlitch() : 0;
 }
 
+void RADIO_GetMeasurement(const VFOContext *ctx, RadioMeasurement *m) {
+  memset(m, 0, sizeof(*m));
+
+  switch (ctx->radio_type) {
+  case RADIO_BK4819:
+    m->rssi = BK4819_GetRSSI();
+    m->noise = BK4819_GetNoise();
+    m->glitch = BK4819_GetGlitch();
+    m->snr = ConvertDomain(BK4819_GetSNR(), 24, 170, 0, 30);
+    break;
+  case RADIO_BK1080:
+    if (gShowAllRSSI) {
+      m->rssi = BK1080_GetRSSI();
+      m->snr = BK1080_GetSNR();
+    }
+    break;
+  case RADIO_SI4732:
+    if (gShowAllRSSI) {
+      const RSQStatus *rsq = siRsq();
+      m->rssi = rsq->resp.RSSI;
+      m->snr = rsq->resp.SNR;
+      m->mult = rsq->resp.MULT;
+    }
+    break;
+  }
+}
+
 static void updateContext() {
   vfo = RADIO_GetCurrentVFO(gRadioState);
   ctx = &vfo->context;
@@ -700,7 +753,8 @@ static void RADIO_ApplyCorrections(VFOContext *ctx, bool save_to_eeprom) {
            ctx->frequency, band->min_freq, band->max_freq);
       ctx->frequency = band->max_freq;
     }
-    ctx->dirty[PARAM_FREQUENCY] = true; // Помечаем как dirty для применения
+    // Помечаем как dirty для применения
+    ctx->dirty |= PARAM_BIT(PARAM_FREQUENCY);
     if (save_to_eeprom) {
       ctx->save_to_eeprom = true;
       ctx->last_save_time = Now();
@@ -718,7 +772,7 @@ static void RADIO_ApplyCorrections(VFOContext *ctx, bool save_to_eeprom) {
           RADIO_GetParamValueString(
               ctx, PARAM_MODULATION)); // Используем новую мод для строки
       ctx->modulation = default_mod;
-      ctx->dirty[PARAM_MODULATION] = true;
+      ctx->dirty |= PARAM_BIT(PARAM_MODULATION);
       if (save_to_eeprom) {
         ctx->save_to_eeprom = true;
         ctx->last_save_time = Now();
@@ -735,7 +789,7 @@ static void RADIO_ApplyCorrections(VFOContext *ctx, bool save_to_eeprom) {
            ctx->bandwidth, default_bw,
            RADIO_GetParamValueString(ctx, PARAM_BANDWIDTH));
       ctx->bandwidth = default_bw;
-      ctx->dirty[PARAM_BANDWIDTH] = true;
+      ctx->dirty |= PARAM_BIT(PARAM_BANDWIDTH);
       if (save_to_eeprom) {
         ctx->save_to_eeprom = true;
         ctx->last_save_time = Now();
@@ -797,13 +851,13 @@ static void RADIO_UpdateCurrentBand(VFOContext *ctx) {
       band->num_available_mods > 0) {
     ctx->modulation_index = 0;
     ctx->modulation = band->available_mods[0];
-    ctx->dirty[PARAM_MODULATION] = true;
+    ctx->dirty |= PARAM_BIT(PARAM_MODULATION);
   }
   if (ctx->bandwidth_index >= band->num_available_bandwidths &&
       band->num_available_bandwidths > 0) {
     ctx->bandwidth_index = 0;
     ctx->bandwidth = band->available_bandwidths[0];
-    ctx->dirty[PARAM_BANDWIDTH] = true;
+    ctx->dirty |= PARAM_BIT(PARAM_BANDWIDTH);
   }
 }
 
@@ -903,7 +957,7 @@ void RADIO_SetParam(VFOContext *ctx, ParamType param, uint32_t value,
         }
       }
     }
-    ctx->dirty[PARAM_MODULATION] = true;
+    ctx->dirty |= PARAM_BIT(PARAM_MODULATION);
     break;
 
   case PARAM_BANDWIDTH:
@@ -918,7 +972,7 @@ void RADIO_SetParam(VFOContext *ctx, ParamType param, uint32_t value,
         }
       }
     }
-    ctx->dirty[PARAM_BANDWIDTH] = true;
+    ctx->dirty |= PARAM_BIT(PARAM_BANDWIDTH);
     break;
   case PARAM_RX_CODE:
     ctx->code.value = value;
@@ -946,8 +1000,8 @@ void RADIO_SetParam(VFOContext *ctx, ParamType param, uint32_t value,
         BANDS_CalculateOutputPower(ctx->power, ctx->tx_state.frequency);
 
     ctx->tx_state.pa_enabled = true;
-    ctx->dirty[PARAM_TX_POWER] = true;
-    ctx->dirty[PARAM_TX_POWER_AMPLIFIER] = true;
+    ctx->dirty |= PARAM_BIT(PARAM_TX_POWER);
+    ctx->dirty |= PARAM_BIT(PARAM_TX_POWER_AMPLIFIER);
   } break;
   case PARAM_TX_POWER:
     ctx->tx_state.power_level = value;
@@ -998,9 +1052,7 @@ void RADIO_SetParam(VFOContext *ctx, ParamType param, uint32_t value,
   case PARAM_RADIO:
     ctx->radio_type = value;
     // RADIO_UpdateCurrentBand(ctx);
-    for (uint8_t i = 0; i < PARAM_COUNT; ++i) {
-      ctx->dirty[i] = true;
-    }
+    ctx->dirty = PARAM_ALL;
     break;
   case PARAM_TX_FREQUENCY_FACT:
   case PARAM_TX_STATE:
@@ -1025,7 +1077,7 @@ void RADIO_SetParam(VFOContext *ctx, ParamType param, uint32_t value,
 
   // TODO: make dirty only when changed.
   // but, potential BUG: param not applied when 0
-  ctx->dirty[param] = true;
+  ctx->dirty |= PARAM_BIT(param);
 
   // Если значение изменилось и требуется сохранение - устанавливаем флаг
   if (save_to_eeprom && (old_value != value)) {
@@ -1229,20 +1281,12 @@ bool RADIO_IncDecParam(VFOContext *ctx, ParamType param, bool inc,
   return RADIO_AdjustParam(ctx, param, inc ? v : -v, save_to_eeprom);
 }
 
-typedef bool (*spf_ptr)(VFOContext *, ParamType);
-
-static spf_ptr setParamForRadio[] = {
-    [RADIO_BK4819] = &setParamBK4819,
-    [RADIO_BK1080] = &setParamBK1080,
-    [RADIO_SI4732] = &setParamSI4732,
-};
-
 // Применение настроек
 void RADIO_ApplySettings(VFOContext *ctx) {
-  if (ctx->dirty[PARAM_RADIO]) {
+  if (ctx->dirty & PARAM_BIT(PARAM_RADIO)) {
     LogC(LOG_C_BRIGHT_MAGENTA, "[RADIO] =%s",
          RADIO_GetParamValueString(ctx, PARAM_RADIO));
-    ctx->dirty[PARAM_RADIO] = false;
+    ctx->dirty &= ~PARAM_BIT(PARAM_RADIO);
 
     if (ctx->radio_type != RADIO_BK4819) {
       // printf("RADIO IS BC\n");
@@ -1251,41 +1295,21 @@ void RADIO_ApplySettings(VFOContext *ctx) {
   }
 
   const bool needSetupToneDetection =
-      (ctx->dirty[PARAM_RX_CODE] || ctx->dirty[PARAM_TX_CODE] ||
-       ctx->dirty[PARAM_TX_STATE]) &&
+      (ctx->dirty & (PARAM_BIT(PARAM_RX_CODE) | PARAM_BIT(PARAM_TX_CODE) |
+                     PARAM_BIT(PARAM_TX_STATE))) &&
       ctx->radio_type == RADIO_BK4819;
 
-  for (uint8_t p = 0; p < PARAM_COUNT; ++p) {
-    if (!ctx->dirty[p]) {
-      continue;
-    }
+  ctx->dirty &= ~PARAMS_NO_APPLY;
 
-    switch (p) {
-    case PARAM_STEP:
-    case PARAM_POWER:
-    case PARAM_TX_FREQUENCY:
-    case PARAM_TX_OFFSET:
-    case PARAM_TX_OFFSET_DIR:
-    case PARAM_TX_STATE:
-    case PARAM_TX_CODE:
-    case PARAM_RX_CODE:
-    case PARAM_RSSI:
-    case PARAM_NOISE:
-    case PARAM_GLITCH:
-    case PARAM_SNR:
-    case PARAM_PRECISE_F_CHANGE:
-      ctx->dirty[p] = false;
-      continue;
-    }
+  // Обход только установленных битов, по возрастанию: частота последней
+  const ParamApply *plan = RADIO_PLANS[ctx->radio_type];
+  ParamMask pending = ctx->dirty & getPlanMask(ctx->radio_type);
+  while (pending) {
+    ParamType p = __builtin_ctz(pending);
+    pending &= pending - 1;
 
-    if (!setParamForRadio[ctx->radio_type](ctx, p)) {
-#ifdef DEBUG_PARAMS
-      LogC(LOG_C_YELLOW, "[W] Param %s not set for %s", PARAM_NAMES[p],
-           RADIO_NAMES[ctx->radio_type]);
-#endif
-      continue;
-    }
-    ctx->dirty[p] = false;
+    plan[p](ctx);
+    ctx->dirty &= ~PARAM_BIT(p);
 #ifdef DEBUG_PARAMS
     LogC(LOG_C_BRIGHT_WHITE, "[SET] %-12s -> %s", PARAM_NAMES[p],
          RADIO_GetParamValueString(ctx, p));
@@ -1297,6 +1321,58 @@ void RADIO_ApplySettings(VFOContext *ctx) {
   }
 }
 
+// Сессия свипа: радио и границы проверяются один раз в RADIO_SweepBegin,
+// дальше шаг пишет только частоту BK4819 (без RADIO_SetParam/валидации)
+static struct {
+  VFOContext *ctx;
+  uint32_t fMin;
+  uint32_t fMax;
+} sweep;
+
+bool RADIO_SweepBegin(VFOContext *ctx, uint32_t fMin, uint32_t fMax) {
+  const FreqBand *band = ctx->current_band;
+
+  RADIO_SweepEnd();
+  if (ctx->radio_type != RADIO_BK4819 || !band || fMin < band->min_freq ||
+      fMax > band->max_freq) {
+    return false;
+  }
+
+  RADIO_ApplySettings(ctx);
+  sweep.ctx = ctx;
+  sweep.fMin = fMin;
+  sweep.fMax = fMax;
+  return true;
+}
+
+uint16_t RADIO_SweepMeasure(VFOContext *ctx, uint32_t f, bool precise,
+                            uint32_t delayUs) {
+  if (ctx == sweep.ctx && ctx->radio_type == RADIO_BK4819 &&
+      f >= sweep.fMin && f <= sweep.fMax) {
+    ctx->frequency = f;
+    ctx->preciseFChange = precise;
+    bk4819Frequency(ctx);
+  } else {
+    RADIO_SetParam(ctx, PARAM_PRECISE_F_CHANGE, precise, false);
+    RADIO_SetParam(ctx, PARAM_FREQUENCY, f, false);
+    RADIO_ApplySettings(ctx);
+  }
+  SYSTICK_DelayUs(delayUs);
+  return RADIO_GetRSSI(ctx);
+}
+
+void RADIO_SweepEnd(void) {
+  VFOContext *ctx = sweep.ctx;
+  if (!ctx) {
+    return;
+  }
+  sweep.ctx = NULL;
+
+  // Частота уже в регистрах: догоняем учет диапазона и коррекции контекста
+  RADIO_SetParam(ctx, PARAM_FREQUENCY, ctx->frequency, false);
+  RADIO_ApplySettings(ctx);
+}
+
 // Начать передачу
 bool RADIO_StartTX(VFOContext *ctx) {
   TXStatus status = checkTX(ctx);
@@ -1428,8 +1504,11 @@ static bool RADIO_SwitchVFOTemp(RadioState *state, uint8_t vfo_index) {
   VFOContext *oldCtx = &state->vfos[state->active_vfo_index].context;
   VFOContext *newCtx = &state->vfos[vfo_index].context;
 
+  newCtx->dirty = 0;
   for (uint8_t p = 0; p < PARAM_COUNT; ++p) {
-    newCtx->dirty[p] = RADIO_GetParam(oldCtx, p) != RADIO_GetParam(newCtx, p);
+    if (RADIO_GetParam(oldCtx, p) != RADIO_GetParam(newCtx, p)) {
+      newCtx->dirty |= PARAM_BIT(p);
+    }
   }
 
   // mute previous vfo (fast fix)
@@ -1465,8 +1544,11 @@ bool RADIO_SwitchVFO(RadioState *state, uint8_t vfo_index) {
   VFOContext *oldCtx = &state->vfos[state->active_vfo_index].context;
   VFOContext *newCtx = &state->vfos[vfo_index].context;
 
+  newCtx->dirty = 0;
   for (uint8_t p = 0; p < PARAM_COUNT; ++p) {
-    newCtx->dirty[p] = RADIO_GetParam(oldCtx, p) != RADIO_GetParam(newCtx, p);
+    if (RADIO_GetParam(oldCtx, p) != RADIO_GetParam(newCtx, p)) {
+      newCtx->dirty |= PARAM_BIT(p);
+    }
   }
 
   // mute previous vfo (fast fix)
@@ -1696,11 +1778,14 @@ bool RADIO_CheckSquelch(VFOContext *ctx) {
 static void RADIO_UpdateMeasurement(ExtendedVFOContext *vfo) {
   // Log("Update MSM");
   VFOContext *ctx = &vfo->context;
+  RadioMeasurement m;
+  RADIO_GetMeasurement(ctx, &m);
   vfo->msm.f = ctx->frequency;
-  vfo->msm.rssi = RADIO_GetRSSI(ctx);
-  vfo->msm.noise = BK4819_GetNoise();
-  vfo->msm.glitch = BK4819_GetGlitch();
-  vfo->msm.snr = RADIO_GetSNR(ctx);
+  vfo->msm.rssi = m.rssi;
+  vfo->msm.noise = m.noise;
+  vfo->msm.glitch = m.glitch;
+  vfo->msm.snr = m.snr;
+  // Для SI4732 шумодав сравнивает SNR из того же снимка, без второго RSQ
   vfo->msm.open = RADIO_CheckSquelch(ctx);
   if (!gMonitorMode && ctx->radio_type == RADIO_BK4819) {
     LOOT_Update(&vfo->msm);
@@ -1848,9 +1933,7 @@ void RADIO_LoadVFOs(RadioState *state) {
   state->num_vfos = vfoIdx;
 
   VFOContext *ctx = &state->vfos[state->active_vfo_index].context;
-  for (uint8_t p = 0; p < PARAM_COUNT; ++p) {
-    ctx->dirty[p] = true;
-  }
+  ctx->dirty = PARAM_ALL;
 
   RADIO_ApplySettings(ctx);
 
@@ -69,6 +69,12 @@ typedef const enum {
   PARAM_COUNT,
 } ParamType;
 
+// Набор параметров битовой маской, бит на ParamType
+typedef uint32_t ParamMask;
+#define PARAM_BIT(p) (1UL << (p))
+#define PARAM_ALL (PARAM_BIT(PARAM_COUNT) - 1)
+_Static_assert(PARAM_COUNT < 32, "ParamMask: PARAM_ALL shifts by PARAM_COUNT");
+
 typedef enum {
   TX_UNKNOWN,
   TX_ON,
@@ -113,7 +119,7 @@ typedef struct {
   } tx_state;
 
   char name[10];
-  bool dirty[PARAM_COUNT]; // Флаги изменений
+  ParamMask dirty; // Флаги изменений
 
   const FreqBand *current_band; // Активный диапазон
   uint32_t last_save_time; // Время последнего сохранения
@@ -219,11 +225,31 @@ const ExtendedVFOContext *RADIO_GetCurrentVFOConst(const RadioState *state);
 void RADIO_SwitchAudioToVFO(RadioState *state, uint8_t vfo_index);
 void RADIO_UpdateSquelch(RadioState *state);
 
+// Сессия свипа (сканер): шаг без валидации параметров, только частота и
+// RSSI. Вне проверенных границ или не на BK4819 — обычный путь через
+// RADIO_SetParam. RADIO_SweepEnd синхронизирует контекст VFO.
+bool RADIO_SweepBegin(VFOContext *ctx, uint32_t fMin, uint32_t fMax);
+uint16_t RADIO_SweepMeasure(VFOContext *ctx, uint32_t f, bool precise,
+                            uint32_t delayUs);
+void RADIO_SweepEnd(void);
+
 uint16_t RADIO_GetRSSI(const VFOContext *ctx);
 uint8_t RADIO_GetSNR(const VFOContext *ctx);
 uint8_t RADIO_GetNoise(const VFOContext *ctx);
 uint8_t RADIO_GetGlitch(const VFOContext *ctx);
 
+// Снимок измерений активного радио за один проход: SI4732 отвечает одной
+// RSQ-транзакцией на интервал, шум/глитч читаются только у BK4819
+typedef struct {
+  uint16_t rssi;
+  uint8_t snr;
+  uint8_t noise;
+  uint8_t glitch;
+  uint8_t mult; // multipath, только SI4732
+} RadioMeasurement;
+
+void RADIO_GetMeasurement(const VFOContext *ctx, RadioMeasurement *m);
+
 void RADIO_FastSquelchUpdate();
 void RADIO_SlowRSSIUpdate();
 
@@ -14,6 +14,7 @@
 #include <string.h>
 
 static uint32_t saveTime;
+bool dirty[SETTING_COUNT];
 
 static const uint16_t BAT_CAL_MIN = 1900;
 
@@ -106,14 +107,21 @@ const uint16_t PAGE_SIZES[6] = {
 };
 
 void SETTINGS_Save(void) {
-  EEPROM_WriteBuffer(SETTINGS_OFFSET, &gSettings, SETTINGS_SIZE);
+  saveTime = 0;
+  // Флеш-слой сравнит с записанным и перепишет только измененные байты
+  EEPROM_WriteBuffer(SETTINGS_OFFSET, (uint8_t *)&gSettings, SETTINGS_SIZE);
+  for (uint8_t i = 0; i < SETTING_COUNT; ++i) {
+    dirty[i] = false;
+  }
 }
 
 void SETTINGS_Load(void) {
   EEPROM_ReadBuffer(SETTINGS_OFFSET, &gSettings, SETTINGS_SIZE);
 }
 
-void SETTINGS_DelayedSave(void) { SETTINGS_Save(); }
+// Серия изменений (автоповтор клавиш) откладывает запись: на флеш уходит
+// одна запись через SETTINGS_SAVE_DELAY_MS после последнего изменения
+void SETTINGS_DelayedSave(void) { saveTime = Now() + SETTINGS_SAVE_DELAY_MS; }
 
 uint32_t SETTINGS_GetFilterBound(void) {
   return gSettings.bound_240_280 ? VHF_UHF_BOUND2 : VHF_UHF_BOUND1;
@@ -134,7 +142,6 @@ bool SETTINGS_IsPatchPresent() {
   return memcmp(buf, PATCH3_PREAMBLE, 8) == 0;
 }
 
-bool dirty[SETTING_COUNT];
 
 uint32_t SETTINGS_GetValue(Setting s) {
   switch (s) {
@@ -347,7 +354,7 @@ void SETTINGS_SetValue(Setting s, uint32_t v) {
     break;
   case SETTING_BOUND240_280:
     gSettings.bound_240_280 = v;
-    ctx->dirty[PARAM_FILTER] = true; // filter update
+    ctx->dirty |= PARAM_BIT(PARAM_FILTER); // filter update
     RADIO_ApplySettings(ctx);
     break;
   case SETTING_NOLISTEN:
@@ -365,7 +372,7 @@ void SETTINGS_SetValue(Setting s, uint32_t v) {
 
   if (v != ov) {
     dirty[s] = true;
-    saveTime = Now() + 1000;
+    SETTINGS_DelayedSave();
   }
 }
 
@@ -583,10 +590,6 @@ void SETTINGS_IncDecValue(Setting s, bool inc) {
 
 void SETTINGS_UpdateSave() {
   if (saveTime && Now() > saveTime) {
-    saveTime = 0;
     SETTINGS_Save();
-    for (uint8_t i = 0; i < SETTING_COUNT; ++i) {
-      dirty[i] = false;
-    }
   }
 }
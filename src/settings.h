@@ -206,6 +206,9 @@ extern const char *CH_DISPLAY_MODE_NAMES[3];
 extern const char *rogerNames[2];
 extern const char *FC_TIME_NAMES[4];
 
+// Задержка отложенного сохранения настроек, мс
+#define SETTINGS_SAVE_DELAY_MS 2000
+
 void SETTINGS_Save();
 void SETTINGS_Load();
 void SETTINGS_DelayedSave();
@@ -3,8 +3,10 @@
 #include "driver/backlight.h"
 #include "driver/battery.h"
 #include "driver/eeprom.h"
+#include "driver/fat_fs.h"
 #include "driver/keyboard.h"
 #include "driver/st7565.h"
+#include "driver/vcp.h"
 #include "driver/systick.h"
 #include "driver/uart.h"
 #include "external/CMSIS/Device/PY32F071/Include/py32f071xB.h"
@@ -12,6 +14,8 @@
 #include "helper/bands.h"
 #include "helper/menu.h"
 #include "helper/scan.h"
+#include "helper/scheduler.h"
+#include "helper/vfs.h"
 #include "radio.h"
 #include "settings.h"
 #include "ui/graphics.h"
@@ -27,9 +31,7 @@ static uint8_t DEAD_BUF[] = {0xDE, 0xAD};
 static char notificationMessage[16] = "";
 static uint32_t notificationTimeoutAt;
 
-static uint32_t secondTimer;
 static uint32_t radioTimer;
-static uint32_t appsKeyboardTimer;
 
 static uint32_t lastUartDataTime;
 
@@ -38,6 +40,11 @@ static bool isUartWaiting() {
 }
 
 static void appRender() {
+  // common: render 2 times per second minimum
+  if (Now() - gLastRender >= 500) {
+    gRedrawScreen = true;
+  }
+
   if (!gRedrawScreen) {
     return;
   }
@@ -64,10 +71,31 @@ static void appRender() {
 }
 
 static void systemUpdate() {
+  STATUSLINE_update();
+  SYSTICK_UpdateIdleStats();
+  SCHED_UpdateStats();
   BATTERY_UpdateBatteryInfo();
   // BACKLIGHT_Update();
 }
 
+static void radioUpdate() {
+  if (gCurrentApp != APP_RESET) {
+    SCAN_Check();
+  }
+}
+
+static void storageUpdate() {
+  SETTINGS_UpdateSave();
+  FAT_Update();
+  VFS_Update();
+}
+
+// Сканирование и сброс используют каждый проход цикла, остальное
+// ждёт прерываний: SysTick, клавиатура, USB, DMA
+static bool canSleep() {
+  return gCurrentApp != APP_RESET && SCAN_GetMode() == SCAN_MODE_SINGLE;
+}
+
 static bool resetNeeded() {
   uint8_t buf[2];
   EEPROM_ReadBuffer(0, buf, 2);
@@ -151,7 +179,6 @@ void SYS_Main() {
   keyboard_init(onKey);
   printf("kbd init ok\n");
 
-  keyboard_tick_1ms();
   if (/* resetNeeded() || */ keyboard_is_pressed(KEY_EXIT)) {
     initDisplay();
     gSettings.batteryCalibration = 2000;
@@ -170,42 +197,34 @@ void SYS_Main() {
     LogC(LOG_C_BRIGHT_WHITE, "LOAD BANDS");
     BANDS_Load();
 
+    LogC(LOG_C_BRIGHT_WHITE, "USB");
+    FAT_Init();
+    VFS_Init();
+    VCP_Init();
+
     LogC(LOG_C_BRIGHT_WHITE, "RUN DEFAULT APP");
     APPS_run(APP_VFO1);
   }
 
-  for (;;) {
+  SCHED_Add(SCHED_OWNER_SYSTEM, "radio", radioUpdate, 0, SCHED_PRIO_RADIO);
+  SCHED_Add(SCHED_OWNER_SYSTEM, "app", APPS_update, 0, SCHED_PRIO_RADIO);
+  SCHED_Add(SCHED_OWNER_SYSTEM, "keys", keyboard_poll, 0, SCHED_PRIO_KEYS);
+  SCHED_Add(SCHED_OWNER_SYSTEM, "render", appRender, 0, SCHED_PRIO_RENDER);
+  SCHED_Add(SCHED_OWNER_SYSTEM, "storage", storageUpdate, 10,
+            SCHED_PRIO_HOUSEKEEPING);
+  SCHED_Add(SCHED_OWNER_SYSTEM, "system", systemUpdate, 1000,
+            SCHED_PRIO_HOUSEKEEPING);
 
-    SETTINGS_UpdateSave();
-
-    if (gCurrentApp != APP_RESET) {
-      SCAN_Check();
-    }
-
-    APPS_update();
-    if (Now() - appsKeyboardTimer >= 1) {
-      keyboard_tick_1ms();
-      appsKeyboardTimer = Now();
-    }
-
-    // common: render 2 times per second minimum
-    if (Now() - gLastRender >= 500) {
-      gRedrawScreen = true;
-    }
-
-    if (Now() - secondTimer >= 1000) {
-      STATUSLINE_update();
-      systemUpdate();
-      secondTimer = Now();
-    }
-
-    appRender();
+  for (;;) {
+    SCHED_Run();
 
     /* while (gCurrentApp != APP_SCANER && UART_IsCommandAvailable()) {
       UART_HandleCommand();
       lastUartDataTime = Now();
     } */
 
-    // __WFI();
+    if (canSleep()) {
+      SYSTICK_Sleep();
+    }
   }
 }
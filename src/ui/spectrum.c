@@ -23,22 +23,122 @@ static uint8_t filledPoints;
 static Band *range;
 static uint16_t step;
 
-static void drawTicks(uint8_t y, uint32_t fs, uint32_t fe, uint32_t div,
-                      uint8_t h) {
-  for (uint32_t f = fs - (fs % div) + div; f < fe; f += div) {
-    DrawVLine(SP_F2X(f), y, h, C_FILL);
+// Статистика по rssiHistory, поддерживается в setBin()
+static uint32_t sumSq;
+static uint16_t statMax, statMin, statNoise;
+static uint8_t statMaxX, statMinX;
+static bool maxDirty, minDirty, noiseDirty;
+
+// Детектор пиков: бины финализируются по мере прохода
+#define PEAKS_MAX 8
+#define PEAK_THRESHOLD 12 // над шумом
+#define PEAK_WIDE_BINS 3  // от скольки бинов сигнал считается широким
+
+static Peak peaks[PEAKS_MAX];
+static Peak peaksNext[PEAKS_MAX];
+static uint8_t peaksCount;
+static uint8_t peaksNextCount;
+static uint8_t peakX;     // следующий нефинализированный бин
+static uint16_t peakLevel; // порог текущего прохода
+static bool runOpen;
+static uint8_t runStart;
+static uint16_t runRssi;
+static uint8_t curPeak;
+
+// Отображение частота <-> пиксель, пересчитывается только при смене
+// границ диапазона: binHz = (txF - rxF) / 127, деление через обратную
+// величину 2^32 / binHz с коррекцией, результат равен delta / binHz
+static uint32_t mapF0 = UINT32_MAX, mapF1;
+static uint32_t binHz;
+static uint32_t binRecip;
+
+#define TICKS_MAX 32
+static uint8_t tickX[TICKS_MAX];
+static uint8_t tickH[TICKS_MAX];
+static uint8_t ticksCount;
+static uint32_t ticksF0 = UINT32_MAX, ticksF1;
+
+static void updateMapping(void) {
+  if (range->rxF == mapF0 && range->txF == mapF1) {
+    return;
+  }
+  mapF0 = range->rxF;
+  mapF1 = range->txF;
+  binHz = mapF1 > mapF0 ? (mapF1 - mapF0) / (MAX_POINTS - 1) : 0;
+  binRecip = binHz > 1 ? (uint32_t)((1ULL << 32) / binHz) : 0;
+  ticksF0 = UINT32_MAX;
+}
+
+static void addTicks(uint32_t fs, uint32_t fe, uint32_t div, uint8_t h) {
+  for (uint32_t f = fs - (fs % div) + div; f < fe && ticksCount < TICKS_MAX;
+       f += div) {
+    tickX[ticksCount] = SP_F2X(f);
+    tickH[ticksCount] = h;
+    ticksCount++;
   }
 }
 
 void UI_DrawTicks(uint8_t y, const Band *band) {
   uint32_t fs = band->rxF, fe = band->txF, bw = fe - fs;
-  for (uint32_t p = 100000000; p >= 10; p /= 10) {
-    if (p < bw) {
-      drawTicks(y, fs, fe, p / 2, 2);
-      drawTicks(y, fs, fe, p, 3);
-      return;
+
+  if (fs != ticksF0 || fe != ticksF1) {
+    ticksF0 = fs;
+    ticksF1 = fe;
+    ticksCount = 0;
+    for (uint32_t p = 100000000; p >= 10; p /= 10) {
+      if (p < bw) {
+        addTicks(fs, fe, p / 2, 2);
+        addTicks(fs, fe, p, 3);
+        break;
+      }
+    }
+  }
+
+  for (uint8_t i = 0; i < ticksCount; ++i) {
+    DrawVLine(tickX[i], y, tickH[i], C_FILL);
+  }
+}
+
+static void resetStats(void) {
+  sumSq = 0;
+  for (uint8_t i = 0; i < MAX_POINTS; ++i) {
+    sumSq += rssiHistory[i] * rssiHistory[i];
+  }
+  maxDirty = minDirty = noiseDirty = true;
+}
+
+static void setBin(uint8_t i, uint16_t v) {
+  uint16_t old = rssiHistory[i];
+  rssiHistory[i] = v;
+  sumSq = sumSq - old * old + v * v;
+  noiseDirty = true;
+
+  if (!maxDirty) {
+    if (v >= statMax) {
+      statMax = v;
+      statMaxX = i;
+    } else if (i == statMaxX) {
+      maxDirty = true;
     }
   }
+
+  // Как MinRSSI: нулевой бин 0 входит в минимум, остальные нули — нет
+  if (!minDirty) {
+    if (i == 0 || i == statMinX) {
+      minDirty = true;
+    } else if (v && v < statMin) {
+      statMin = v;
+      statMinX = i;
+    }
+  }
+}
+
+static void resetPeaks(void) {
+  peaksCount = peaksNextCount = 0;
+  peakX = 0;
+  peakLevel = UINT16_MAX;
+  runOpen = false;
+  curPeak = 0;
 }
 
 void SP_ResetHistory(void) {
@@ -46,6 +146,8 @@ void SP_ResetHistory(void) {
   for (uint8_t i = 0; i < MAX_POINTS; ++i) {
     rssiHistory[i] = 0;
   }
+  resetStats();
+  resetPeaks();
 }
 
 void SP_Begin(void) {
@@ -57,6 +159,8 @@ void SP_Init(Band *b) {
   S_BOTTOM = SPECTRUM_Y + SPECTRUM_H;
   range = b;
   step = StepFrequencyTable[b->step];
+  mapF0 = UINT32_MAX;
+  updateMapping();
   SP_ResetHistory();
   SP_Begin();
 }
@@ -70,41 +174,110 @@ void SP_Init(Band *b) {
 } */
 
 uint8_t SP_F2X(uint32_t f) {
+  updateMapping();
+
   // 1. Проверка границ (Clamp)
-  if (f <= range->rxF)
+  if (f <= mapF0)
     return 0;
-  if (f >= range->txF)
+  if (f >= mapF1)
     return MAX_POINTS - 1;
 
-  uint32_t delta = f - range->rxF;
-  uint32_t aRange = range->txF - range->rxF;
-
-  // Вместо: (delta * 127) / aRange
-  // Делаем: delta / (aRange / 127)
-
-  // Предварительно считаем делитель (шаг частоты на 1 пиксель)
-  // +1 для округления вверх, чтобы не делить на 0, если диапазон схлопнут
-  uint32_t step = aRange / (MAX_POINTS - 1);
+  if (binHz == 0)
+    return 0; // Защита: диапазон уже 127 единиц
+  if (binHz == 1)
+    return f - mapF0; // < 127
 
-  if (step == 0)
-    return 0; // Защита
-
-  // Результат гарантированно < 128, так как delta < aRange
-  return delta / step;
+  uint32_t delta = f - mapF0;
+  uint32_t q = ((uint64_t)delta * binRecip) >> 32;
+  // Обратная величина округлена вниз: частное может быть меньше на 1
+  if (delta - q * binHz >= binHz) {
+    q++;
+  }
+  return q;
 }
 
 uint32_t SP_X2F(uint8_t x) {
-  // Защита от выхода за массив (хотя uint8_t x вряд ли превысит, если
-  // MAX_POINTS > 255)
+  updateMapping();
+
   if (x >= MAX_POINTS)
     x = MAX_POINTS - 1;
 
-  // Считаем шаг частоты на один пиксель
-  // Лучше вынести расчет step в место, где меняется range, чтобы не делить
-  // каждый раз!
-  uint32_t step = (range->txF - range->rxF) / (MAX_POINTS - 1);
+  return mapF0 + x * binHz;
+}
+
+static void closeRun(uint8_t end) {
+  runOpen = false;
+
+  uint32_t fs = SP_X2F(runStart);
+  uint32_t fe = end + 1 < MAX_POINTS ? SP_X2F(end + 1) : range->txF;
+  Peak p = {
+      .f = fs + (fe - fs) / 2,
+      .bw = fe - fs,
+      .rssi = runRssi,
+      .x = runStart + (end - runStart) / 2,
+      .width = end - runStart + 1,
+  };
+
+  if (p.width >= PEAK_WIDE_BINS) {
+    LOOT_Add(RoundToStep(p.f, step));
+  }
+
+  // Список упорядочен по x; при переполнении вытесняем самый слабый
+  uint8_t n = peaksNextCount;
+  if (n == PEAKS_MAX) {
+    uint8_t weakest = 0;
+    for (uint8_t i = 1; i < n; ++i) {
+      if (peaksNext[i].rssi < peaksNext[weakest].rssi) {
+        weakest = i;
+      }
+    }
+    if (peaksNext[weakest].rssi >= p.rssi) {
+      return;
+    }
+    for (uint8_t i = weakest; i < n - 1; ++i) {
+      peaksNext[i] = peaksNext[i + 1];
+    }
+    n--;
+  }
+  peaksNext[n] = p;
+  peaksNextCount = n + 1;
+}
 
-  return range->rxF + (x * step);
+static void finalizeBin(uint8_t i) {
+  uint16_t v = rssiHistory[i];
+  if (v && v >= peakLevel) {
+    if (!runOpen) {
+      runOpen = true;
+      runStart = i;
+      runRssi = 0;
+    }
+    if (v > runRssi) {
+      runRssi = v;
+    }
+  } else if (runOpen) {
+    closeRun(i - 1);
+  }
+}
+
+static void endSweep(void) {
+  while (peakX < filledPoints) {
+    finalizeBin(peakX++);
+  }
+  if (runOpen) {
+    closeRun(peakX - 1);
+  }
+
+  for (uint8_t i = 0; i < peaksNextCount; ++i) {
+    peaks[i] = peaksNext[i];
+  }
+  peaksCount = peaksNextCount;
+  if (curPeak >= peaksCount) {
+    curPeak = 0;
+  }
+
+  peaksNextCount = 0;
+  peakX = 0;
+  peakLevel = SP_GetNoiseFloor() + PEAK_THRESHOLD;
 }
 
 void SP_AddPoint(const Measurement *msm) {
@@ -124,19 +297,28 @@ void SP_AddPoint(const Measurement *msm) {
     xe = temp;
   }
 
+  // Бины левее текущей точки больше не изменятся
+  if (xs < peakX) {
+    endSweep();
+  }
+  while (peakX < xs) {
+    finalizeBin(peakX++);
+  }
+
   // TODO: debug this range
   for (x = xs; x < MAX_POINTS && x <= xe; ++x) {
     if (ox != x) {
       ox = x;
-      rssiHistory[x] = 0;
+      setBin(x, 0);
     }
     if (msm->rssi > rssiHistory[x]) {
-      rssiHistory[x] = msm->rssi;
+      setBin(x, msm->rssi);
     }
   }
   // not x+1 as we going to xe inclusive
   if (x > filledPoints) {
     filledPoints = x;
+    noiseDirty = true;
   }
   if (filledPoints > MAX_POINTS) {
     filledPoints = MAX_POINTS;
@@ -168,9 +350,24 @@ static uint16_t MinRSSI(const uint16_t *array, size_t n) {
 #define _MIN(a, b) (((a) < (b)) ? (a) : (b))
 #define _MAX(a, b) (((a) > (b)) ? (a) : (b))
 
+static uint16_t getMin(void) {
+  if (minDirty) {
+    statMin = MinRSSI(rssiHistory, filledPoints);
+    statMinX = 0;
+    for (uint8_t i = 1; i < filledPoints; ++i) {
+      if (rssiHistory[i] == statMin) {
+        statMinX = i;
+        break;
+      }
+    }
+    minDirty = false;
+  }
+  return statMin;
+}
+
 VMinMax SP_GetMinMax() {
-  const uint16_t rssiMin = MinRSSI(rssiHistory, filledPoints);
-  const uint16_t rssiMax = Max(rssiHistory, filledPoints);
+  const uint16_t rssiMin = getMin();
+  const uint16_t rssiMax = SP_GetRssiMax();
   const uint16_t noiseFloor = SP_GetNoiseFloor();
   const uint16_t rssiDiff = rssiMax - rssiMin;
 
@@ -332,8 +529,38 @@ void SP_RenderLine(uint16_t rssi, VMinMax v) {
   DrawHLine(0, S_BOTTOM - yVal, filledPoints, C_FILL);
 }
 
-uint16_t SP_GetNoiseFloor() { return Std(rssiHistory, filledPoints); }
-uint16_t SP_GetRssiMax() { return Max(rssiHistory, filledPoints); }
+uint16_t SP_GetNoiseFloor() {
+  if (noiseDirty) {
+    statNoise = filledPoints ? Sqrt(sumSq / filledPoints) : 0;
+    noiseDirty = false;
+  }
+  return statNoise;
+}
+
+uint16_t SP_GetRssiMax() {
+  if (maxDirty) {
+    statMax = 0;
+    statMaxX = 0;
+    for (uint8_t i = 0; i < filledPoints; ++i) {
+      if (rssiHistory[i] > statMax) {
+        statMax = rssiHistory[i];
+        statMaxX = i;
+      }
+    }
+    maxDirty = false;
+  }
+  return statMax;
+}
+
+const Peak *SP_GetPeaks(uint8_t *count) {
+  *count = peaksCount;
+  return peaks;
+}
+
+const uint16_t *SP_GetHistory(uint8_t *count) {
+  *count = filledPoints;
+  return rssiHistory;
+}
 
 uint16_t SP_GetLastGraphValue() { return rssiGraphHistory[MAX_POINTS - 1]; }
 
@@ -389,6 +616,7 @@ void SP_AddGraphPoint(const Measurement *msm) {
 
   rssiGraphHistory[MAX_POINTS - 1] = v;
   filledPoints = MAX_POINTS;
+  noiseDirty = true;
 }
 
 static void shiftEx(uint16_t *history, uint16_t n, int16_t shift) {
@@ -412,7 +640,10 @@ static void shiftEx(uint16_t *history, uint16_t n, int16_t shift) {
   }
 }
 
-void SP_Shift(int16_t n) { shiftEx(rssiHistory, MAX_POINTS, n); }
+void SP_Shift(int16_t n) {
+  shiftEx(rssiHistory, MAX_POINTS, n);
+  resetStats();
+}
 void SP_ShiftGraph(int16_t n) { shiftEx(rssiGraphHistory, MAX_POINTS, n); }
 
 static uint8_t curX = MAX_POINTS / 2;
@@ -471,6 +702,31 @@ uint32_t CUR_GetCenterF(uint32_t step) {
   return RoundToStep(SP_X2F(curX), step);
 }
 
+static void setCurX(uint8_t cx) {
+  if (cx < curSbWidth) {
+    cx = curSbWidth;
+  }
+  if (cx > MAX_POINTS - 1 - curSbWidth) {
+    cx = MAX_POINTS - 1 - curSbWidth;
+  }
+  curX = cx;
+}
+
+bool CUR_NextPeak(bool up) {
+  if (!peaksCount) {
+    return false;
+  }
+  if (up) {
+    curPeak = curPeak + 1 < peaksCount ? curPeak + 1 : 0;
+  } else {
+    curPeak = curPeak ? curPeak - 1 : peaksCount - 1;
+  }
+  setCurX(peaks[curPeak].x);
+  return true;
+}
+
+const Peak *CUR_GetPeak() { return peaksCount ? &peaks[curPeak] : NULL; }
+
 void CUR_Reset() {
   curX = MAX_POINTS / 2;
   curSbWidth = 16;
@@ -11,6 +11,14 @@ typedef struct {
   uint16_t vMax;
 } VMinMax;
 
+typedef struct {
+  uint32_t f;  // центр занятой полосы
+  uint32_t bw; // оценка занятой полосы
+  uint16_t rssi;
+  uint8_t x;
+  uint8_t width; // бинов выше порога
+} Peak;
+
 typedef enum {
   GRAPH_RSSI,
   GRAPH_NOISE,
@@ -29,6 +37,8 @@ void SP_RenderLine(uint16_t rssi, VMinMax v);
 void SP_RenderArrow(uint32_t f);
 uint16_t SP_GetNoiseFloor();
 uint16_t SP_GetRssiMax();
+const uint16_t *SP_GetHistory(uint8_t *count);
+const Peak *SP_GetPeaks(uint8_t *count);
 VMinMax SP_GetMinMax();
 
 void SP_NextGraphUnit(bool next);
@@ -46,6 +56,8 @@ Band CUR_GetRange(Band *p, uint32_t step);
 uint32_t CUR_GetCenterF(uint32_t step);
 void CUR_Reset();
 bool CUR_Size(bool up);
+bool CUR_NextPeak(bool up);
+const Peak *CUR_GetPeak();
 
 extern uint8_t SPECTRUM_Y;
 extern uint8_t SPECTRUM_H;
@@ -8,6 +8,7 @@
 #include "../helper/bands.h"
 #include "../helper/channels.h"
 #include "../helper/numnav.h"
+#include "../helper/recorder.h"
 #include "components.h"
 #include "graphics.h"
 #include <string.h>
@@ -91,6 +92,10 @@ void STATUSLINE_render(void) {
     icons[idx++] = SYM_EEPROM_W;
   }
 
+  if (REC_IsActive()) {
+    icons[idx++] = SYM_FILE;
+  }
+
   if (LOOT_Size() == LOOT_SIZE_MAX) {
     icons[idx++] = SYM_LOOT_FULL;
   }
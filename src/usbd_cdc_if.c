@@ -1,18 +1,22 @@
 #include "usbd_core.h"
 #include "usbd_cdc.h"
+#include "usbd_msc.h"
 
 /*!< endpoint address */
 #define CDC_IN_EP  0x81
 #define CDC_OUT_EP 0x02
 #define CDC_INT_EP 0x83
 
+#define MSC_IN_EP  0x84
+#define MSC_OUT_EP 0x04
+
 #define USBD_VID           0x36b7
 #define USBD_PID           0xFFFF
 #define USBD_MAX_POWER     100
 #define USBD_LANGID_STRING 1033
 
 /*!< config descriptor size */
-#define USB_CONFIG_SIZE (9 + CDC_ACM_DESCRIPTOR_LEN)
+#define USB_CONFIG_SIZE (9 + CDC_ACM_DESCRIPTOR_LEN + MSC_DESCRIPTOR_LEN)
 
 uint8_t dma_in_ep_idx  = (CDC_IN_EP & 0x7f);
 uint8_t dma_out_ep_idx = CDC_OUT_EP;
@@ -20,8 +24,9 @@ uint8_t dma_out_ep_idx = CDC_OUT_EP;
 /*!< global descriptor */
 static const uint8_t cdc_descriptor[] = {
     USB_DEVICE_DESCRIPTOR_INIT(USB_2_0, 0xEF, 0x02, 0x01, USBD_VID, USBD_PID, 0x0100, 0x01),
-    USB_CONFIG_DESCRIPTOR_INIT(USB_CONFIG_SIZE, 0x02, 0x01, USB_CONFIG_BUS_POWERED, USBD_MAX_POWER),
+    USB_CONFIG_DESCRIPTOR_INIT(USB_CONFIG_SIZE, 0x03, 0x01, USB_CONFIG_BUS_POWERED, USBD_MAX_POWER),
     CDC_ACM_DESCRIPTOR_INIT(0x00, CDC_INT_EP, CDC_OUT_EP, CDC_IN_EP, 0x02),
+    MSC_DESCRIPTOR_INIT(0x02, MSC_OUT_EP, MSC_IN_EP, 0x00),
     ///////////////////////////////////////
     /// string0 descriptor
     ///////////////////////////////////////
@@ -158,6 +163,7 @@ struct usbd_endpoint cdc_in_ep = {
 
 struct usbd_interface intf0;
 struct usbd_interface intf1;
+struct usbd_interface intf2;
 
 void cdc_acm_init(cdc_acm_rx_buf_t rx_buf)
 {
@@ -170,6 +176,8 @@ void cdc_acm_init(cdc_acm_rx_buf_t rx_buf)
     usbd_add_interface(usbd_cdc_acm_init_intf(&intf1));
     usbd_add_endpoint(&cdc_out_ep);
     usbd_add_endpoint(&cdc_in_ep);
+    /* composite: flash FAT volume as a mass storage drive */
+    usbd_add_interface(usbd_msc_init_intf(&intf2, MSC_OUT_EP, MSC_IN_EP));
     usbd_initialize();
 }
 
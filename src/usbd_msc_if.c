@@ -0,0 +1,54 @@
+#include "usbd_core.h"
+#include "usbd_msc.h"
+#include "driver/fat_fs.h"
+#include "helper/vfs.h"
+
+void usbd_msc_get_cap(uint8_t lun, uint32_t *block_num, uint16_t *block_size)
+{
+    *block_num = FAT_TOTAL_SECTORS;
+    *block_size = FAT_SECTOR_SIZE;
+}
+
+int usbd_msc_sector_read(uint32_t sector, uint8_t *buffer, uint32_t length)
+{
+    for (uint32_t o = 0; o < length; o += FAT_SECTOR_SIZE, sector++) {
+        if (!VFS_Read(sector, buffer + o)) {
+            FAT_ReadBlock(sector, buffer + o);
+        }
+    }
+    return 0;
+}
+
+/* Следующий сектор читается DMA, пока текущий уходит в шину */
+int usbd_msc_sector_read_start(uint32_t sector, uint8_t *buffer, uint32_t length)
+{
+    if (length != FAT_SECTOR_SIZE) {
+        return usbd_msc_sector_read(sector, buffer, length);
+    }
+    if (VFS_Read(sector, buffer)) {
+        return 0;
+    }
+    FAT_ReadBlockStart(sector, buffer);
+    return 0;
+}
+
+int usbd_msc_sector_read_wait(void)
+{
+    PY25Q16_ReadWait();
+    return 0;
+}
+
+/* LBA оседают в кеше записи FAT, стирание — раз на 4 КБ блок */
+int usbd_msc_sector_write(uint32_t sector, uint8_t *buffer, uint32_t length)
+{
+    for (uint32_t o = 0; o < length; o += FAT_SECTOR_SIZE) {
+        VFS_Write(sector, buffer + o);
+        FAT_WriteBlock(sector++, buffer + o);
+    }
+    return 0;
+}
+
+void usbd_msc_sync_cache(uint8_t lun)
+{
+    FAT_Flush();
+}